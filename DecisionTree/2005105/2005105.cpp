@@ -8,11 +8,12 @@
 #define ITERATIONS 20
 #define TRAIN_PERCENTAGE 0.8
 
-vector<Car> readDataset(ifstream &instream)
+// Reading every row into dataset, false after reporting the first malformed row
+bool readDataset(ifstream &instream, Dataset &dataset)
 {
 
-    vector<Car> cars;
     string str;
+    int line_number = 0;
 
     while (true)
     {
@@ -20,11 +21,15 @@ vector<Car> readDataset(ifstream &instream)
         if (instream.eof())
             break;
 
-        Car car(str);
-        cars.push_back(car);
+        line_number++;
+        if (!dataset.addRow(str))
+        {
+            cout << "Invalid row at line " << line_number << ": " << str << endl;
+            return false;
+        }
     }
 
-    return cars;
+    return true;
 }
 
 int main(int argc, char **argv)
@@ -40,18 +45,25 @@ int main(int argc, char **argv)
         cout << "Error while opening the input file" << endl;
         return 1;
     }
-    vector<Car> cars = readDataset(instream);
+    Dataset dataset(column_names, column_values);
+    bool valid = readDataset(instream, dataset);
     instream.close();
-    if (cars.empty())
+    if (!valid)
+        return 1;
+    if (dataset.size() == 0)
     {
         cout << "No data found in the input file." << endl;
         return 1;
     }
 
-    double best_ig = getAccuracy(cars, information_gain, rng, 1);
-    double best_gini = getAccuracy(cars, gini_impurity, rng, 1);
-    double top_3_ig = getAccuracy(cars, information_gain, rng, 3);
-    double top_3_gini = getAccuracy(cars, gini_impurity, rng, 3);
+    Rows rows(dataset.size());
+    for (size_t row = 0; row < rows.size(); row++)
+        rows[row] = row;
+
+    double best_ig = getAccuracy(dataset, rows, information_gain, rng, 1);
+    double best_gini = getAccuracy(dataset, rows, gini_impurity, rng, 1);
+    double top_3_ig = getAccuracy(dataset, rows, information_gain, rng, 3);
+    double top_3_gini = getAccuracy(dataset, rows, gini_impurity, rng, 3);
 
     print_accuracy_table(best_ig, best_gini, top_3_ig, top_3_gini);
     return 0;
@@ -9,57 +9,81 @@
 
 using namespace std;
 
-map<string, int> count_values(vector<Car> &dataset, string attr)
+// Rows of the dataset taking part in one step of the learner
+typedef vector<uint32_t> Rows;
+
+// Rows per value code of column attr
+vector<int> count_values(const Dataset &dataset, const Rows &rows, int attr)
 {
-    map<string, int> counts;
-    for (auto &car : dataset)
-    {
-        counts[car.getCarAttribute(attr)]++;
-    }
+    vector<int> counts(dataset.getValueCount(attr), 0);
+    const vector<uint8_t> &column = dataset.getColumn(attr);
+    for (uint32_t row : rows)
+        counts[column[row]]++;
     return counts;
 }
 
-vector<Car> filter_dataset(vector<Car> &dataset, string attr, string value)
+// Rows per (value of attr, class) pair in one pass, indexed value * classes + class
+vector<int> count_value_classes(const Dataset &dataset, const Rows &rows, int attr, int class_column)
 {
-    vector<Car> filtered;
-    for (auto &car : dataset)
+    size_t classes = dataset.getValueCount(class_column);
+    vector<int> counts(dataset.getValueCount(attr) * classes, 0);
+    const vector<uint8_t> &column = dataset.getColumn(attr);
+    const vector<uint8_t> &labels = dataset.getColumn(class_column);
+    for (uint32_t row : rows)
+        counts[column[row] * classes + labels[row]]++;
+    return counts;
+}
+
+Rows filter_dataset(const Dataset &dataset, const Rows &rows, int attr, uint8_t value)
+{
+    Rows filtered;
+    const vector<uint8_t> &column = dataset.getColumn(attr);
+    for (uint32_t row : rows)
     {
-        if (car.getCarAttribute(attr) == value)
+        if (column[row] == value)
         {
-            filtered.push_back(car);
+            filtered.push_back(row);
         }
     }
     return filtered;
 }
 
-string plurality_value(vector<Car> &dataset)
+// Most frequent class, ties go to the alphabetically first class name
+uint8_t plurality_value(const Dataset &dataset, const Rows &rows)
 {
-    map<string, int> temp_map = count_values(dataset, class_attr);
-    pair<string, int> return_pair = {"", -1};
-    for (auto temp_pair : temp_map)
-        if (temp_pair.second > return_pair.second)
-            return_pair = temp_pair;
-    return return_pair.first;
+    int class_column = dataset.getColumnIndex(class_attr);
+    vector<int> counts = count_values(dataset, rows, class_column);
+    int best = -1;
+    for (uint8_t cls : dataset.getSortedCodes(class_column))
+        if (counts[cls] > 0 && (best < 0 || counts[cls] > counts[best]))
+            best = cls;
+    return max(best, 0);
 }
 
-double information_gain(vector<Car> &dataset, string attr)
+// Expected class entropy after splitting on attr (lower is better), values and classes summed in
+// alphabetical order of their names
+double information_gain(const Dataset &dataset, const Rows &rows, int attr)
 {
-    int total_size = dataset.size();
+    int total_size = rows.size();
+    int class_column = dataset.getColumnIndex(class_attr);
+    size_t classes = dataset.getValueCount(class_column);
 
-    map<string, int> attr_counts = count_values(dataset, attr);
+    vector<int> counts = count_value_classes(dataset, rows, attr, class_column);
     double ig = 0.0;
 
-    for (auto &[value, count] : attr_counts)
+    for (uint8_t value : dataset.getSortedCodes(attr))
     {
+        int count = 0;
+        for (size_t cls = 0; cls < classes; cls++)
+            count += counts[value * classes + cls];
+        if (count == 0)
+            continue;
         double p = static_cast<double>(count) / total_size;
-        vector<Car> filtered = filter_dataset(dataset, attr, value);
 
-        map<string, int> filtered_class_counts = count_values(filtered, class_attr);
         double entropy = 0.0;
-
-        for (auto &[cls, fcount] : filtered_class_counts)
+        for (uint8_t cls : dataset.getSortedCodes(class_column))
         {
-            double q = static_cast<double>(fcount) / count;
+            double q = static_cast<double>(counts[value * classes + cls]) / count;
             if (q > 0)
             {
                 entropy -= q * log2(q);
@@ -71,22 +95,27 @@ double information_gain(vector<Car> &dataset, string attr)
     return ig;
 }
 
-double gini_impurity(vector<Car> &dataset, string attr) {
-    int total_size = dataset.size();
+double gini_impurity(const Dataset &dataset, const Rows &rows, int attr) {
+    int total_size = rows.size();
     if (total_size == 0) return 0.0; 
 
-    map<string, int> attr_counts = count_values(dataset, attr);
+    int class_column = dataset.getColumnIndex(class_attr);
+    size_t classes = dataset.getValueCount(class_column);
+
+    vector<int> counts = count_value_classes(dataset, rows, attr, class_column);
     double gini = 0.0;
 
-    for (auto &[value, count] : attr_counts) {
+    for (uint8_t value : dataset.getSortedCodes(attr)) {
+        int count = 0;
+        for (size_t cls = 0; cls < classes; cls++)
+            count += counts[value * classes + cls];
+        if (count == 0)
+            continue;
         double p = static_cast<double>(count) / total_size;
 
         double impurity = 1.0;
-
-        vector<Car> filtered = filter_dataset(dataset, attr, value);
-        map<string, int> filtered_class_counts = count_values(filtered, class_attr);
-        for (auto &[cls, fcount] : filtered_class_counts) {
-            double q = static_cast<double>(fcount) / count;
+        for (uint8_t cls : dataset.getSortedCodes(class_column)) {
+            double q = static_cast<double>(counts[value * classes + cls]) / count;
             impurity -= q * q;
         }
 
@@ -96,12 +125,12 @@ double gini_impurity(vector<Car> &dataset, string attr) {
     return gini;
 }
 
-Node *train_decision_tree(vector<Car> &dataset, vector<string> &attributes, vector<Car> &parent_dataset,
-                          double (*metric)(vector<Car> &, string), int k=1, int min_size = 5, double threshold = 0.01)
+Node *train_decision_tree(const Dataset &dataset, const Rows &rows, vector<int> &attributes, const Rows &parent_rows,
+                          double (*metric)(const Dataset &, const Rows &, int), int k=1, int min_size = 5, double threshold = 0.01)
 {
 
-    string majority_class = plurality_value(parent_dataset);
-    if (dataset.empty())
+    uint8_t majority_class = plurality_value(dataset, parent_rows);
+    if (rows.empty())
     {
         Node *leaf = new Node();
         leaf->setIsLeaf(true);
@@ -109,16 +138,17 @@ Node *train_decision_tree(vector<Car> &dataset, vector<string> &attributes, vect
         return leaf;
     }
 
-    map<string, int> class_counts = count_values(dataset, class_attr);
-    if (class_counts.size() == 1)
+    vector<int> class_counts = count_values(dataset, rows, dataset.getColumnIndex(class_attr));
+    if (count(class_counts.begin(), class_counts.end(), 0) + 1 == static_cast<int>(class_counts.size()))
     {
         Node *leaf = new Node();
         leaf->setIsLeaf(true);
-        leaf->setLabel(class_counts.begin()->first);
+        leaf->setLabel(find_if(class_counts.begin(), class_counts.end(), [](int c)
+                               { return c > 0; }) - class_counts.begin());
         return leaf;
     }
 
-    majority_class = plurality_value(dataset);
+    majority_class = plurality_value(dataset, rows);
     if (attributes.empty())
     {
         Node *leaf = new Node();
@@ -127,7 +157,7 @@ Node *train_decision_tree(vector<Car> &dataset, vector<string> &attributes, vect
         return leaf;
     }
 
-    // if (dataset.size() < min_size)
+    // if (rows.size() < min_size)
     // {
     //     Node *leaf = new Node();
     //     leaf->setIsLeaf(true);
@@ -135,16 +165,16 @@ Node *train_decision_tree(vector<Car> &dataset, vector<string> &attributes, vect
     //     return leaf;
     // }
 
-    string best_attribute;
+    int best_attribute;
     double best_score;
 
-    vector<pair<string, double>> scores;
+    vector<pair<int, double>> scores;
     for (auto &attr : attributes)
     {
-        double score = metric(dataset, attr);
+        double score = metric(dataset, rows, attr);
         scores.push_back({attr, score});
     }
-    sort(scores.begin(), scores.end(), [](const pair<string, double> &a, const pair<string, double> &b)
+    sort(scores.begin(), scores.end(), [](const pair<int, double> &a, const pair<int, double> &b)
          { return a.second < b.second; });
 
     if(k == 1){
@@ -176,12 +206,14 @@ Node *train_decision_tree(vector<Car> &dataset, vector<string> &attributes, vect
     tree->setNodeAttribute(best_attribute);
     tree->setLabel(majority_class);
 
-    map<string, int> attr_values = count_values(dataset, best_attribute);
+    vector<int> attr_values = count_values(dataset, rows, best_attribute);
 
-    for (auto &[value, _] : attr_values)
+    for (uint8_t value : dataset.getSortedCodes(best_attribute))
     {
-        vector<Car> filtered = filter_dataset(dataset, best_attribute, value);
-        vector<string> remaining_attributes;
+        if (attr_values[value] == 0)
+            continue;
+        Rows filtered = filter_dataset(dataset, rows, best_attribute, value);
+        vector<int> remaining_attributes;
         for (auto &attr : attributes)
         {
             if (attr != best_attribute)
@@ -189,34 +221,39 @@ Node *train_decision_tree(vector<Car> &dataset, vector<string> &attributes, vect
                 remaining_attributes.push_back(attr);
             }
         }
-        tree->setChild(value, train_decision_tree(filtered, remaining_attributes, dataset, metric, k));
+        tree->setChild(value, train_decision_tree(dataset, filtered, remaining_attributes, rows, metric, k));
     }
 
     return tree;
 }
 
-double getAccuracy(vector<Car> &cars, double (*metric)(vector<Car> &, string), default_random_engine rng, int k = 1)
+// rows is shuffled in place for every split into training and test rows
+double getAccuracy(const Dataset &dataset, Rows &rows, double (*metric)(const Dataset &, const Rows &, int), default_random_engine rng, int k = 1)
 {
 
     double total_accuracy = 0;
+    int class_column = dataset.getColumnIndex(class_attr);
+    vector<int> attribute_columns;
+    for (auto &attr : attributes)
+        attribute_columns.push_back(dataset.getColumnIndex(attr));
 
     for (int i = 0; i < ITERATIONS; i++)
     {
-        shuffle(cars.begin(), cars.end(), rng);
+        shuffle(rows.begin(), rows.end(), rng);
 
-        size_t train_size = static_cast<size_t>(cars.size() * TRAIN_PERCENTAGE);
-        vector<Car> training_set(cars.begin(), cars.begin() + train_size);
-        vector<Car> test_set(cars.begin() + train_size, cars.end());
+        size_t train_size = static_cast<size_t>(rows.size() * TRAIN_PERCENTAGE);
+        Rows training_set(rows.begin(), rows.begin() + train_size);
+        Rows test_set(rows.begin() + train_size, rows.end());
 
-        Node *root = train_decision_tree(training_set, attributes, training_set, metric, k);
+        Node *root = train_decision_tree(dataset, training_set, attribute_columns, training_set, metric, k);
         DecisionTree tree(root);
 
-        string predicted, actual;
+        uint8_t predicted, actual;
         int correct = 0;
-        for (auto &car : test_set)
+        for (uint32_t row : test_set)
         {
-            predicted = tree.getClassification(car);
-            actual = car.getCarAttribute(class_attr);
+            predicted = tree.getClassification(dataset, row);
+            actual = dataset.getCode(class_column, row);
             if (predicted == actual)
                 correct++;
         }
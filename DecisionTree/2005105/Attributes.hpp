@@ -4,6 +4,7 @@
 #include <cassert>
 #include <map>
 #include <string>
+#include <cstdint>
 
 using namespace std;
 
@@ -24,6 +25,11 @@ vector<string> lug_attr_values = {"small", "med", "big"};
 vector<string> safety_attr_values = {"low", "med", "high"};
 vector<string> class_attr_values = {"unacc", "acc", "good", "vgood"};
 
+// Columns of car.data in file order, the class last, with their known values
+vector<string> column_names = {buy_attr, maint_attr, door_attr, person_attr, lug_attr, safety_attr, class_attr};
+vector<vector<string>> column_values = {buy_attr_values, maint_attr_values, door_attr_values, person_attr_values,
+                                        lug_attr_values, safety_attr_values, class_attr_values};
+
 void print_accuracy_table(double best_ig, double best_gini, double top_3_ig, double top_3_gini){
  
     cout << "====================================================================================================" << endl;
@@ -0,0 +1,98 @@
+#include "Attributes.hpp"
+#include <algorithm>
+
+// Columnar dataset: every attribute is one column of small integer codes, a code indexes the column's
+// dictionary of values. Dictionaries start from the known values and grow with values found while parsing.
+// Subsets of the data are lists of row indices, the columns themselves are never copied.
+// Codes follow the order values are met in, the learner visits them in alphabetical order of their values
+// (getSortedCodes) so its results do not depend on the encoding.
+class Dataset
+{
+    vector<string> names;
+    vector<vector<string>> dictionaries; // per column, value of each code
+    vector<vector<uint8_t>> columns;     // per column, code of each row
+    vector<vector<uint8_t>> sorted;      // per column, codes in alphabetical order of their values
+    size_t rows = 0;
+
+    void insertSorted(int column, uint8_t code)
+    {
+        vector<uint8_t> &codes = sorted[column];
+        auto position = upper_bound(codes.begin(), codes.end(), code, [&](uint8_t a, uint8_t b)
+                                    { return dictionaries[column][a] < dictionaries[column][b]; });
+        codes.insert(position, code);
+    }
+
+public:
+    Dataset(const vector<string> &Names, const vector<vector<string>> &Values)
+        : names(Names), dictionaries(Values), columns(Names.size()), sorted(Names.size())
+    {
+        assert(names.size() == dictionaries.size());
+        for (size_t column = 0; column < names.size(); column++)
+            for (size_t code = 0; code < dictionaries[column].size(); code++)
+                insertSorted(column, code);
+    }
+
+    // Appending one comma separated row, false if it has the wrong number of fields
+    // or a column would need more than 256 values. A rejected row leaves the dataset unchanged.
+    bool addRow(const string &line)
+    {
+        vector<string> fields;
+        stringstream ss(line);
+        string value;
+        while (fields.size() < names.size() && getline(ss, value, ','))
+            fields.push_back(value);
+        if (fields.size() != names.size() || ss.good())
+            return false;
+
+        // Codes of the row, -1 for values the dictionaries do not have yet
+        vector<int> codes(names.size());
+        for (size_t column = 0; column < names.size(); column++)
+        {
+            codes[column] = findCode(column, fields[column]);
+            if (codes[column] < 0 && dictionaries[column].size() > UINT8_MAX)
+                return false;
+        }
+
+        // Accepted, new values join the dictionaries now
+        for (size_t column = 0; column < names.size(); column++)
+        {
+            if (codes[column] < 0)
+            {
+                codes[column] = dictionaries[column].size();
+                dictionaries[column].push_back(fields[column]);
+                insertSorted(column, codes[column]);
+            }
+            columns[column].push_back(codes[column]);
+        }
+        rows++;
+        return true;
+    }
+
+    size_t size() const { return rows; }
+    size_t getColumnCount() const { return names.size(); }
+
+    // Column of an attribute, -1 if there is none
+    int getColumnIndex(const string &attr) const
+    {
+        for (size_t column = 0; column < names.size(); column++)
+            if (names[column] == attr)
+                return column;
+        return -1;
+    }
+
+    const string &getColumnName(int column) const { return names[column]; }
+    const vector<uint8_t> &getColumn(int column) const { return columns[column]; }
+    uint8_t getCode(int column, size_t row) const { return columns[column][row]; }
+    size_t getValueCount(int column) const { return dictionaries[column].size(); }
+    const string &getValue(int column, uint8_t code) const { return dictionaries[column][code]; }
+    const vector<uint8_t> &getSortedCodes(int column) const { return sorted[column]; }
+
+    // Code of value in column, -1 if the column has no such value
+    int findCode(int column, const string &value) const
+    {
+        for (size_t code = 0; code < dictionaries[column].size(); code++)
+            if (dictionaries[column][code] == value)
+                return code;
+        return -1;
+    }
+};
\ No newline at end of file
@@ -1,14 +1,14 @@
-#include "Car.hpp"
+#include "Dataset.hpp"
 
 class Node
 {
-    string attribute;
-    map<string, Node *> children;
-    string label;
+    int attribute = -1;             // column tested
+    map<uint8_t, Node *> children;  // by value code
+    uint8_t label = 0;              // class code
     bool is_leaf = false;
 
 public:
-    Node(bool init_is_leaf = false, string init_class = "") : is_leaf(init_is_leaf), label(init_class) {}
+    Node(bool init_is_leaf = false, uint8_t init_class = 0) : label(init_class), is_leaf(init_is_leaf) {}
     ~Node()
     {
         if (is_leaf)
@@ -18,20 +18,24 @@ public:
                 delete child.second;
     }
 
-    void setNodeAttribute(string node_attr) { attribute = node_attr; }
-    string getNodeAttribute() { return attribute; }
+    void setNodeAttribute(int node_attr) { attribute = node_attr; }
+    int getNodeAttribute() { return attribute; }
 
     void setIsLeaf(bool Is_leaf) { is_leaf = Is_leaf; }
     bool getIsLeaf() { return is_leaf; }
 
-    void setLabel(string Label) { label = Label; }
-    string getLabel() { return label; }
+    void setLabel(uint8_t Label) { label = Label; }
+    uint8_t getLabel() { return label; }
 
-    void setChildren(map<string, Node *> Children) { children = Children; }
-    map<string, Node *> getChildren() { return children; }
+    void setChildren(map<uint8_t, Node *> Children) { children = Children; }
+    map<uint8_t, Node *> getChildren() { return children; }
 
-    Node* getChild(string attr) { return children[attr]; }
-    void setChild(string attr, Node * node) { children[attr] = node; }
+    Node *getChild(uint8_t value)
+    {
+        auto child = children.find(value);
+        return child == children.end() ? NULL : child->second;
+    }
+    void setChild(uint8_t value, Node *node) { children[value] = node; }
 };
 
 class DecisionTree
@@ -45,12 +49,14 @@ public:
         if (root)
             delete root;
     }
-    string getClassification(Car car)
+
+    // Class code predicted for one row of dataset
+    uint8_t getClassification(const Dataset &dataset, size_t row)
     {
         Node *node = root;
         while (node && !(node->getIsLeaf()))
         {
-            string attr_value = car.getCarAttribute(node->getNodeAttribute());
+            uint8_t attr_value = dataset.getCode(node->getNodeAttribute(), row);
             if(node->getChild(attr_value)) node = node->getChild(attr_value);
             else break;
         }
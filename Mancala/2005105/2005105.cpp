@@ -5,6 +5,14 @@ int main()
     // Rand function for randomly setting game depth and heuristic choice
     srand(time(0));
 
+    // Using the endgame database if one has been built
+    load_endgame_database<Board>();
+    load_opening_book<Board>();
+
+    // Using the tuned evaluation weights if the tuner has written them
+    if (load_default_weights(WEIGHTS_FILE))
+        cout << "Evaluation weights loaded from " << WEIGHTS_FILE << endl;
+
     // Making game choice and calling specific function
     int game_choice;
 
@@ -13,7 +21,14 @@ int main()
         cout << "Choose Game Mode:" << endl;
         cout << "1. Play vs. Computer" << endl;
         cout << "2. Run hundred-game simulation" << endl;
-        cout << "3. Exit" << endl;
+        cout << "3. Build endgame database" << endl;
+        cout << "4. Check packed sowing and search, benchmark sowing" << endl;
+        cout << "5. Run variant tournament" << endl;
+        cout << "6. Benchmark MCTS against minimax" << endl;
+        cout << "7. Tune evaluation weights" << endl;
+        cout << "8. Build opening book" << endl;
+        cout << "9. Analyze game log" << endl;
+        cout << "10. Exit" << endl;
 
         cin >> game_choice;
         if (game_choice == 1)
@@ -21,6 +36,20 @@ int main()
         else if (game_choice == 2)
             run_hundred_game_simulation();
         else if (game_choice == 3)
+            build_endgame_database();
+        else if (game_choice == 4)
+            run_sowing_check_and_benchmark();
+        else if (game_choice == 5)
+            run_variant_tournament();
+        else if (game_choice == 6)
+            run_mcts_benchmark();
+        else if (game_choice == 7)
+            run_weight_tuner();
+        else if (game_choice == 8)
+            build_opening_book();
+        else if (game_choice == 9)
+            run_game_log_analysis();
+        else if (game_choice == 10)
             break;
         else
             cout << "Invalid choice" << endl;
@@ -1,93 +1,351 @@
-#include "game_board.hpp"
+#include "game_book.hpp"
+#include <thread>
+#include <atomic>
+#include <unordered_set>
 
-// Minimax algorithm with alpha-beta pruning
-int minimax(Board &board, int depth, int alpha, int beta, int player, int heuristic)
+// The search is templated on the board type, so every Kalah variant gets its own fully specialized code
+
+// Optional time limit of the search running on this thread
+struct SearchDeadline
 {
-    // Base case: if the game is over or max depth is reached
-    if (depth <= 0 || board.is_game_over())
-        return board.evaluate(player, heuristic, 0, 0);
+    bool active = false;
+    bool expired = false;
+    unsigned checks = 0;
+    chrono::steady_clock::time_point time;
+};
+
+inline SearchDeadline &thread_search_deadline()
+{
+    thread_local SearchDeadline deadline;
+    return deadline;
+}
+
+// Looking at the clock every 1024 nodes only
+inline bool search_time_is_up()
+{
+    SearchDeadline &deadline = thread_search_deadline();
+    if (!deadline.active)
+        return false;
+    if (!deadline.expired && (++deadline.checks & 1023) == 0 && chrono::steady_clock::now() >= deadline.time)
+        deadline.expired = true;
+    return deadline.expired;
+}
+
+// Only a running timed search is ever cut short
+inline bool search_deadline_expired()
+{
+    const SearchDeadline &deadline = thread_search_deadline();
+    return deadline.active && deadline.expired;
+}
 
-    // Maximizing player
-    if (player == PLAYER_1)
+// Deadline of one timed search, cleared again when the search returns so later searches on the thread run in full
+struct ScopedSearchDeadline
+{
+    explicit ScopedSearchDeadline(double seconds)
     {
-        int max_value = NEG_INF;
+        SearchDeadline &deadline = thread_search_deadline();
+        deadline = SearchDeadline();
+        deadline.active = true;
+        deadline.time = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
+    }
+    ~ScopedSearchDeadline() { thread_search_deadline() = SearchDeadline(); }
+    ScopedSearchDeadline(const ScopedSearchDeadline &) = delete;
+    ScopedSearchDeadline &operator=(const ScopedSearchDeadline &) = delete;
+};
 
-        for (int i = 0; i < NUMBER_OF_BINS; ++i)
-        {
-            if (board.bins[i] == 0)
-                continue;
+// Moves of the player ordered for the search: extra turns first, then captures, then the rest in bin order
+// tactical_moves receives the number of extra turns and captures at the front
+template <class BoardType>
+int order_moves(const BoardType &board, int player, int *moves, int *tactical_moves = nullptr)
+{
+    constexpr int NUMBER_OF_BINS = BoardType::NUMBER_OF_BINS;
+    constexpr int TOTAL_BINS = BoardType::TOTAL_BINS;
+    int first_bin = (player == PLAYER_1) ? 0 : NUMBER_OF_BINS + 1;
+    int storage_index = (player == PLAYER_1) ? BoardType::PLAYER_1_STORAGE : BoardType::PLAYER_2_STORAGE;
+    int extra_turns = 0, captures = 0, others = 0;
+    int capture_moves[NUMBER_OF_BINS], other_moves[NUMBER_OF_BINS];
 
-            Board temp_board = board;
-            auto move_metrics = temp_board.make_move(i, PLAYER_1);
+    for (int bin_index = first_bin; bin_index < first_bin + NUMBER_OF_BINS; ++bin_index)
+    {
+        int stones = board.bins[bin_index];
+        if (stones == 0)
+            continue;
 
-            // If the player gets another turn
-            if (move_metrics.first)
-                max_value = max(max_value, minimax(temp_board, depth, alpha, beta, PLAYER_1, heuristic));
-            else
-                max_value = max(max_value, minimax(temp_board, depth - 1, alpha, beta, PLAYER_2, heuristic));
+        int landing_index = bin_index + stones;
+        if (landing_index == storage_index)
+            moves[extra_turns++] = bin_index;
+        else if (landing_index < storage_index && board.bins[landing_index] == 0 && board.bins[TOTAL_BINS - 2 - landing_index] > 0)
+            capture_moves[captures++] = bin_index;
+        else
+            other_moves[others++] = bin_index;
+    }
 
-            // Updating alpha for maximizing player
-            alpha = max(alpha, max_value);
-            if (beta <= alpha)
-                break;  // Alpha-beta pruning
-        }
-        return max_value;
+    copy(capture_moves, capture_moves + captures, moves + extra_turns);
+    copy(other_moves, other_moves + others, moves + extra_turns + captures);
+    if (tactical_moves)
+        *tactical_moves = extra_turns + captures;
+    return extra_turns + captures + others;
+}
+
+// Principal variation search in negamax form
+// Values are from the side to move's point of view, another_turn and stones_captured describe the last move
+// (positive when the side to move made it, which only happens after an extra turn)
+template <class BoardType>
+int pvs(BoardType &board, int depth, int alpha, int beta, int player, const Evaluator &evaluator,
+        int another_turn = 0, int stones_captured = 0)
+{
+    count_node();
+    if (search_time_is_up())
+        return 0; // the unfinished iteration is thrown away
+
+    // Exact value if the position is in the endgame database
+    const EndgameDatabase<BoardType> &database = endgame_database<BoardType>();
+    if (database.is_loaded())
+    {
+        int final_diff;
+        bool hit = database.probe(board, player, final_diff);
+        count_table_probe(hit);
+        if (hit)
+            return evaluator.score(player == PLAYER_1 ? final_diff : -final_diff, 0, 0, 0);
     }
-    // Minimizing player
-    else
+
+    // Base case: if the game is over or max depth is reached
+    if (depth <= 0 || board.is_game_over())
     {
-        int min_value = INF;
+        count_leaf_evaluation();
+        return board.evaluate(player, evaluator, another_turn, stones_captured);
+    }
 
-        for (int i = 0; i < NUMBER_OF_BINS; ++i)
-        {
-            if (board.bins[NUMBER_OF_BINS + i + 1] == 0)
-                continue;
+    int opponent = (player == PLAYER_1) ? PLAYER_2 : PLAYER_1;
+    int moves[BoardType::NUMBER_OF_BINS];
+    int move_count = order_moves(board, player, moves);
+    int best_value = NEG_INF;
 
-            Board temp_board = board;
-            auto move_metrics = temp_board.make_move(NUMBER_OF_BINS + i + 1, PLAYER_2);
+    for (int move_ordinal = 0; move_ordinal < move_count; ++move_ordinal)
+    {
+        BoardType temp_board = board;
+        auto [extra_turn, captured] = temp_board.make_move(moves[move_ordinal], player);
 
-            // If the player gets another turn
-            if (move_metrics.first)
-                min_value = min(min_value, minimax(temp_board, depth, alpha, beta, PLAYER_2, heuristic));
-            else
-                min_value = min(min_value, minimax(temp_board, depth - 1, alpha, beta, PLAYER_1, heuristic));
+        // An extra turn keeps the same side to move at the same depth, so the window is not negated
+        auto search = [&](int a, int b)
+        {
+            if (extra_turn)
+                return pvs(temp_board, depth, a, b, player, evaluator, 1, captured);
+            return -pvs(temp_board, depth - 1, -b, -a, opponent, evaluator, 0, -captured);
+        };
 
-            // Updating beta for minimizing player
-            beta = min(beta, min_value);
+        int value;
+        if (move_ordinal == 0)
+            value = search(alpha, beta);
+        else
+        {
+            // Null window to prove the move is not better, full re-search if it is
+            value = search(alpha, alpha + 1);
+            if (value > alpha && value < beta)
+                value = search(alpha, beta);
+        }
 
-            if (beta <= alpha)
-                break;  // Alpha-beta pruning
+        best_value = max(best_value, value);
+        alpha = max(alpha, value);
+        if (alpha >= beta)
+        {
+            count_beta_cutoff(move_ordinal);
+            break;
         }
-        return min_value;
     }
+    return best_value;
 }
 
-// Function to get the best move for the current player
-int get_best_move(Board &board, int depth, int heuristic, int player)
+struct RootResult
 {
-    int best_bin_index = -1;
-    int best_bin_value = (player == PLAYER_1) ? NEG_INF : INF;
+    int bin_index;
+    int value;
+};
+
+// Searching the root moves in bin order, so ties go to the lowest bin like a full-window search
+template <class BoardType>
+RootResult search_root(BoardType &board, int depth, int alpha, int beta, int player, const Evaluator &evaluator)
+{
+    constexpr int NUMBER_OF_BINS = BoardType::NUMBER_OF_BINS;
     int opponent = (player == PLAYER_1) ? PLAYER_2 : PLAYER_1;
+    RootResult result = {-1, NEG_INF};
 
     for (int i = 0; i < NUMBER_OF_BINS; ++i)
     {
         int bin_index = (player == PLAYER_1) ? i : (NUMBER_OF_BINS + i + 1);
-
         if (board.bins[bin_index] == 0)
             continue;
 
-        Board temp_board = board;
+        BoardType temp_board = board;
         auto [extra_turn, captured] = temp_board.make_move(bin_index, player);
 
-        int value_of_move = minimax(temp_board, extra_turn ? depth : depth - 1, NEG_INF, INF, extra_turn ? player : opponent, heuristic);
+        auto search = [&](int a, int b)
+        {
+            if (extra_turn)
+                return pvs(temp_board, depth, a, b, player, evaluator, 1, captured);
+            return -pvs(temp_board, depth - 1, -b, -a, opponent, evaluator, 0, -captured);
+        };
+
+        int value;
+        if (result.bin_index == -1)
+            value = search(alpha, beta);
+        else
+        {
+            value = search(alpha, alpha + 1);
+            if (value > alpha && value < beta)
+                value = search(alpha, beta);
+        }
+
+        // A later move only wins by proving a strictly higher value
+        if (result.bin_index == -1 || value > result.value)
+            result = {bin_index, value};
+
+        alpha = max(alpha, value);
+        if (alpha >= beta || search_deadline_expired())
+            break;
+    }
+    return result;
+}
+
+// Half width of the first aspiration window, about two stones in the evaluator's units
+int aspiration_window(const Evaluator &evaluator)
+{
+    int stone_value = (evaluator.heuristic >= 2) ? evaluator.storage_weight : 1;
+    return 2 * max(stone_value, 1) + evaluator.noise;
+}
+
+// Iterative deepening with aspiration windows around the previous iteration's score
+template <class BoardType>
+RootResult iterative_deepening(BoardType &board, int depth, const Evaluator &evaluator, int player)
+{
+    RootResult best = {-1, 0};
+    for (int iteration_depth = 1; iteration_depth <= max(depth, 1); ++iteration_depth)
+    {
+        uint64_t iteration_start = thread_search_stats().nodes;
+
+        // Depth 1 always finishes with the deadline held off, so a timed search has a complete result to play
+        if (iteration_depth == 1)
+        {
+            SearchDeadline &deadline = thread_search_deadline();
+            bool active = deadline.active;
+            deadline.active = false;
+            best = search_root(board, iteration_depth, NEG_INF, INF, player, evaluator);
+            deadline.active = active;
+            count_iteration(thread_search_stats().nodes - iteration_start);
+            continue;
+        }
+        if (search_deadline_expired())
+            break;
+
+        int window = aspiration_window(evaluator);
+        int alpha = max(best.value - window, NEG_INF);
+        int beta = min(best.value + window, INF);
+        while (true)
+        {
+            RootResult result = search_root(board, iteration_depth, alpha, beta, player, evaluator);
+            if (search_deadline_expired())
+                break; // keeping the move of the last finished iteration
+            if (result.value <= alpha && alpha > NEG_INF)
+                alpha = (window *= 2) > INF / 4 ? NEG_INF : max(best.value - window, NEG_INF); // failed low, widening
+            else if (result.value >= beta && beta < INF)
+                beta = (window *= 2) > INF / 4 ? INF : min(best.value + window, INF); // failed high, widening
+            else
+            {
+                best = result;
+                count_iteration(thread_search_stats().nodes - iteration_start);
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+// Function to get the best move for the current player
+// The opening book answers first, otherwise the position is searched
+// thread_search_stats() holds the statistics of this call afterwards
+template <class BoardType>
+int get_best_move(BoardType &board, int depth, const Evaluator &evaluator, int player)
+{
+    thread_search_stats() = SearchStats();
+
+    BookRecord record;
+    if (opening_book<BoardType>().probe(board, player, evaluator, depth, record))
+        return record.bin_index;
+
+    auto start_time = chrono::steady_clock::now();
+    RootResult best = iterative_deepening(board, depth, evaluator, player);
+
+    if constexpr (SEARCH_STATS_ENABLED)
+        thread_search_stats().seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+
+    return best.bin_index;
+}
+
+template <class BoardType>
+int get_best_move(BoardType &board, int depth, int heuristic, int player)
+{
+    return get_best_move(board, depth, make_evaluator(heuristic), player);
+}
 
-        bool is_better_move = (player == PLAYER_1) ? (value_of_move > best_bin_value) : (value_of_move < best_bin_value);
-        if (is_better_move)
+// Searching deeper until the time budget runs out, the move of the last finished iteration is played
+template <class BoardType>
+int get_best_move_timed(BoardType &board, double seconds, const Evaluator &evaluator, int player, int max_depth = 64)
+{
+    ScopedSearchDeadline deadline(seconds);
+    return get_best_move(board, max_depth, evaluator, player);
+}
+
+// Building the opening book of a variant: every position within plies moves of the start, searched to depth
+// Positions are searched in parallel, the search itself never probes the book
+template <class BoardType>
+bool build_opening_book(int plies, int depth, const Evaluator &evaluator, const string &path, ostream &progress)
+{
+    // Distinct positions by hash, an extra turn counts as a ply of its own
+    vector<pair<BoardType, int>> positions;
+    unordered_set<uint64_t> seen;
+    vector<pair<BoardType, int>> frontier(1, {BoardType(), PLAYER_1});
+    for (int ply = 0; ply <= plies && !frontier.empty(); ++ply)
+    {
+        vector<pair<BoardType, int>> next;
+        for (auto &[board, player] : frontier)
         {
-            best_bin_value = value_of_move;
-            best_bin_index = bin_index;
+            if (board.is_game_over())
+                continue;
+            if (!seen.insert(position_hash(board, player)).second)
+                continue;
+            positions.push_back({board, player});
+
+            int first_bin = (player == PLAYER_1) ? 0 : BoardType::NUMBER_OF_BINS + 1;
+            for (int bin_index = first_bin; bin_index < first_bin + BoardType::NUMBER_OF_BINS; ++bin_index)
+            {
+                if (board.bins[bin_index] == 0)
+                    continue;
+                BoardType child = board;
+                bool extra_turn = child.make_move(bin_index, player).first;
+                next.push_back({child, extra_turn ? player : 1 - player});
+            }
         }
+        frontier.swap(next);
+        progress << "Book ply " << ply << ": " << positions.size() << " positions" << endl;
     }
 
-    return best_bin_index;
+    vector<BookRecord> records(positions.size());
+    atomic<size_t> next_position(0);
+    auto worker = [&]
+    {
+        for (size_t i = next_position++; i < positions.size(); i = next_position++)
+        {
+            BoardType board = positions[i].first;
+            RootResult best = iterative_deepening(board, depth, evaluator, positions[i].second);
+            records[i] = {position_hash(board, positions[i].second), best.value, static_cast<uint8_t>(best.bin_index), {0, 0, 0}};
+        }
+    };
+
+    vector<thread> workers;
+    for (unsigned t = 0; t < max(1u, thread::hardware_concurrency()); ++t)
+        workers.emplace_back(worker);
+    for (auto &w : workers)
+        w.join();
+
+    return OpeningBook<BoardType>::write(path, records, plies, depth, evaluator);
 }
\ No newline at end of file
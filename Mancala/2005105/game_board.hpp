@@ -1,11 +1,24 @@
-#include "game_constants.hpp"
+#include "game_evaluator.hpp"
 
-struct Board
+// Kalah(PITS, SEEDS) board: PITS pits per side, SEEDS stones in each pit at the start
+// Bins 0..PITS-1 are player 1's pits, then player 1's storage, player 2's pits and player 2's storage
+template <int PITS, int SEEDS>
+struct KalahBoard
 {
-    vector<int> bins;
+    static constexpr int NUMBER_OF_BINS = PITS;
+    static constexpr int STONES_PER_BIN = SEEDS;
+    static constexpr int TOTAL_BINS = NUMBER_OF_BINS + NUMBER_OF_BINS + 2;
+    static constexpr int PLAYER_1_STORAGE = NUMBER_OF_BINS;
+    static constexpr int PLAYER_2_STORAGE = TOTAL_BINS - 1;
+    static constexpr int TOTAL_STONES = 2 * NUMBER_OF_BINS * STONES_PER_BIN;
 
-    Board() : bins(TOTAL_BINS, 4)
+    static_assert(PITS >= 1 && PITS <= MAX_NUMBER_OF_BINS, "unsupported number of pits");
+
+    array<int, TOTAL_BINS> bins;
+
+    KalahBoard()
     {
+        bins.fill(STONES_PER_BIN);
         bins[PLAYER_1_STORAGE] = bins[PLAYER_2_STORAGE] = 0;
     }
 
@@ -63,7 +76,7 @@ struct Board
         {
             current_index = (current_index + 1) % TOTAL_BINS;
             if (current_index == opponent_storage)
-                continue;
+                current_index = (current_index + 1) % TOTAL_BINS; // skipping the store without dropping a stone
             bins[current_index]++;
         }
 
@@ -79,28 +92,25 @@ struct Board
         return {current_index == storage_index, stones_captured};
     }
 
-    int evaluate(int player, int heuristic_type, int another_turn, int stones_captured)
+    // Heuristic value of the board for the given player
+    // another_turn and stones_captured describe the move that led here, positive when it favoured player
+    int evaluate(int player, const Evaluator &evaluator, int another_turn, int stones_captured)
     {
         int player_storage = (player == PLAYER_1) ? PLAYER_1_STORAGE : PLAYER_2_STORAGE;
         int opponent_storage = (player == PLAYER_1) ? PLAYER_2_STORAGE : PLAYER_1_STORAGE;
-        int score = bins[player_storage] - bins[opponent_storage];
-
-        int stones_on_my_side = accumulate(bins.begin(), bins.begin() + NUMBER_OF_BINS, 0);
-        int stones_on_opponent_side = accumulate(bins.begin() + NUMBER_OF_BINS + 1, bins.end() - 1, 0);
 
-        int bias[] = {rand() % 20 + 1, rand() % 30 + 1, rand() % 40 + 1, rand() % 30 + 1};
+        int stones_on_player_1_side = accumulate(bins.begin(), bins.begin() + NUMBER_OF_BINS, 0);
+        int stones_on_player_2_side = accumulate(bins.begin() + NUMBER_OF_BINS + 1, bins.end() - 1, 0);
+        int side_diff = (player == PLAYER_1) ? stones_on_player_1_side - stones_on_player_2_side
+                                             : stones_on_player_2_side - stones_on_player_1_side;
 
-        if (heuristic_type >= 2)
-            score = score * bias[0] + (stones_on_my_side - stones_on_opponent_side) * bias[1];
-        if (heuristic_type >= 3)
-            score += another_turn * bias[2];
-        if (heuristic_type == 4)
-            score += stones_captured * bias[3];
-
-        return score;
+        return evaluator.score(bins[player_storage] - bins[opponent_storage], side_diff, another_turn, stones_captured);
     }
 };
 
+// Standard Kalah(6, 4), the board used by the interactive game and the hundred-game simulation
+using Board = KalahBoard<6, 4>;
+
 struct Heuristic_Pair
 {
 
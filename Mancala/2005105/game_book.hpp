@@ -0,0 +1,152 @@
+#include "game_stats.hpp"
+
+// Opening book: best moves and values of every position reachable within a few plies of the start
+//
+// Records are (position hash, value, move) sorted by hash and probed with a binary search in the mapped file.
+// A book is built with one evaluator and depth, recorded in the header, and only answers searches with the
+// same evaluator and exactly that depth, so a book move is what the search itself would have played.
+
+const char BOOK_MAGIC[4] = {'M', 'K', 'O', 'B'};
+const uint32_t BOOK_VERSION = 1;
+
+struct BookHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t bins_per_side;
+    uint32_t stones_per_bin;
+    uint32_t plies;
+    uint32_t depth;
+    int32_t heuristic;
+    int32_t storage_weight;
+    int32_t side_weight;
+    int32_t extra_turn_weight;
+    int32_t capture_weight;
+    uint32_t record_count;
+};
+
+struct BookRecord
+{
+    uint64_t hash;
+    int32_t value; // search value from the side to move's point of view
+    uint8_t bin_index;
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(BookHeader) % alignof(BookRecord) == 0, "records must stay aligned after the header");
+
+inline string opening_book_file(int bins_per_side, int stones_per_bin)
+{
+    if (bins_per_side == 6 && stones_per_bin == 4)
+        return "mancala_book.bin";
+    return "mancala_book_" + to_string(bins_per_side) + "_" + to_string(stones_per_bin) + ".bin";
+}
+
+// 64-bit hash of the pits, storages and side to move (splitmix64 finalizer over each bin)
+template <class AnyBoard>
+uint64_t position_hash(const AnyBoard &board, int player)
+{
+    uint64_t hash = 0x84222325CBF29CE4ULL ^ static_cast<uint64_t>(player);
+    for (int i = 0; i < AnyBoard::TOTAL_BINS; ++i)
+    {
+        hash += 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(board.bins[i]);
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+        hash ^= hash >> 31;
+    }
+    return hash;
+}
+
+template <class BoardType>
+class OpeningBook
+{
+    MappedFile file;
+    BookHeader header;
+    const BookRecord *records = nullptr;
+
+public:
+    bool load(const string &path)
+    {
+        records = nullptr;
+        if (!file.open(path))
+            return false;
+
+        if (file.size() < sizeof(header))
+        {
+            file.close();
+            return false;
+        }
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, BOOK_MAGIC, 4) != 0 || header.version != BOOK_VERSION ||
+            header.bins_per_side != BoardType::NUMBER_OF_BINS || header.stones_per_bin != BoardType::STONES_PER_BIN ||
+            file.size() != sizeof(header) + static_cast<size_t>(header.record_count) * sizeof(BookRecord))
+        {
+            file.close();
+            return false;
+        }
+
+        records = reinterpret_cast<const BookRecord *>(file.data() + sizeof(header));
+        return true;
+    }
+
+    bool is_loaded() const { return records != nullptr; }
+    size_t size() const { return records ? header.record_count : 0; }
+    int get_plies() const { return header.plies; }
+    int get_depth() const { return header.depth; }
+
+    // Book move and value for a search with this evaluator and depth, if the book covers it
+    // (a shallower or deeper search would play its own move, the book must not change it)
+    bool probe(const BoardType &board, int player, const Evaluator &evaluator, int depth, BookRecord &record) const
+    {
+        if (!records || depth != static_cast<int>(header.depth) || evaluator.noise != 0 ||
+            evaluator.heuristic != header.heuristic || evaluator.storage_weight != header.storage_weight ||
+            evaluator.side_weight != header.side_weight || evaluator.extra_turn_weight != header.extra_turn_weight ||
+            evaluator.capture_weight != header.capture_weight)
+            return false;
+
+        uint64_t hash = position_hash(board, player);
+        const BookRecord *end = records + header.record_count;
+        const BookRecord *found = lower_bound(records, end, hash, [](const BookRecord &r, uint64_t h)
+                                              { return r.hash < h; });
+        if (found == end || found->hash != hash)
+            return false;
+        record = *found;
+        return true;
+    }
+
+    // Writing records (sorted here) with the header describing how they were searched
+    static bool write(const string &path, vector<BookRecord> &book_records, int plies, int depth, const Evaluator &evaluator)
+    {
+        sort(book_records.begin(), book_records.end(), [](const BookRecord &a, const BookRecord &b)
+             { return a.hash < b.hash; });
+
+        ofstream output(path, ios::binary);
+        if (!output)
+            return false;
+
+        BookHeader book_header;
+        memcpy(book_header.magic, BOOK_MAGIC, 4);
+        book_header.version = BOOK_VERSION;
+        book_header.bins_per_side = BoardType::NUMBER_OF_BINS;
+        book_header.stones_per_bin = BoardType::STONES_PER_BIN;
+        book_header.plies = plies;
+        book_header.depth = depth;
+        book_header.heuristic = evaluator.heuristic;
+        book_header.storage_weight = evaluator.storage_weight;
+        book_header.side_weight = evaluator.side_weight;
+        book_header.extra_turn_weight = evaluator.extra_turn_weight;
+        book_header.capture_weight = evaluator.capture_weight;
+        book_header.record_count = static_cast<uint32_t>(book_records.size());
+        output.write(reinterpret_cast<const char *>(&book_header), sizeof(book_header));
+        output.write(reinterpret_cast<const char *>(book_records.data()), book_records.size() * sizeof(BookRecord));
+        return static_cast<bool>(output);
+    }
+};
+
+// Shared read-only book of a variant, empty until loaded
+template <class BoardType>
+OpeningBook<BoardType> &opening_book()
+{
+    static OpeningBook<BoardType> book;
+    return book;
+}
\ No newline at end of file
@@ -1,21 +1,85 @@
-#include "game_algo.hpp"
+#include "game_log.hpp"
 
-int computer_vs_computer_simulation(int depth, int heuristic1, int heuristic2)
+enum class AgentType
 {
-    Board board;
+    MINIMAX,
+    MCTS
+};
 
-    while (!board.is_game_over())
+// A computer player: minimax to a fixed depth or for a time budget, or MCTS
+struct Agent
+{
+    AgentType type = AgentType::MINIMAX;
+    int depth = 6;
+    int heuristic = 1;
+    double seconds = 0;     // time per move, a minimax agent searches to depth when 0
+    MctsOptions mcts;
+
+    static Agent minimax(int depth, int heuristic)
+    {
+        Agent agent;
+        agent.depth = depth;
+        agent.heuristic = heuristic;
+        return agent;
+    }
+
+    static Agent timed_minimax(double seconds, int heuristic)
+    {
+        Agent agent;
+        agent.heuristic = heuristic;
+        agent.seconds = seconds;
+        return agent;
+    }
+
+    static Agent monte_carlo(const MctsOptions &options)
     {
-        // Player 1's turn
-        int player1_move = get_best_move(board, depth, heuristic1, PLAYER_1);
-        board.make_move(player1_move, PLAYER_1);
+        Agent agent;
+        agent.type = AgentType::MCTS;
+        agent.seconds = options.seconds;
+        agent.mcts = options;
+        return agent;
+    }
+};
+
+// Game between two agents, an extra turn lets the same player move again
+// For MCTS moves the statistics hold the number of playouts as nodes
+template <class BoardType = Board>
+int computer_vs_computer_simulation(const Agent &agent1, const Agent &agent2, GameStats *game_stats = nullptr)
+{
+    BoardType board;
+    const Agent *agents[2] = {&agent1, &agent2};
+    MctsAgent<BoardType> mcts_agents[2] = {MctsAgent<BoardType>(agent1.mcts), MctsAgent<BoardType>(agent2.mcts)};
+    int current_player = PLAYER_1;
 
-        if (board.is_game_over())
-            break;
+    while (!board.is_game_over())
+    {
+        const Agent &agent = *agents[current_player];
+        int move;
+        SearchStats move_stats;
+        if (agent.type == AgentType::MCTS)
+        {
+            auto start_time = chrono::steady_clock::now();
+            move = mcts_agents[current_player].get_best_move(board, current_player);
+            move_stats.nodes = mcts_agents[current_player].get_last_playouts();
+            move_stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        }
+        else
+        {
+            Evaluator evaluator = make_evaluator(agent.heuristic);
+            if (agent.seconds > 0)
+                move = get_best_move_timed(board, agent.seconds, evaluator, current_player);
+            else
+                move = get_best_move(board, agent.depth, evaluator, current_player);
+            move_stats = thread_search_stats();
+        }
 
-        // Player 2's turn
-        int player2_move = get_best_move(board, depth, heuristic2, PLAYER_2);
-        board.make_move(player2_move, PLAYER_2);
+        if (game_stats)
+        {
+            int depth = (agent.type == AgentType::MINIMAX && agent.seconds <= 0) ? agent.depth : 0;
+            game_stats->add_move({current_player, depth, move, move_stats});
+        }
+        bool extra_turn = board.make_move(move, current_player).first;
+        current_player = next_player(current_player, extra_turn);
     }
 
     board.collect_remaining_stones();
@@ -24,7 +88,13 @@ int computer_vs_computer_simulation(int depth, int heuristic1, int heuristic2)
     return game_winner;
 }
 
-// Function for a human vs. computer game
+template <class BoardType = Board>
+int computer_vs_computer_simulation(int depth, int heuristic1, int heuristic2, GameStats *game_stats = nullptr)
+{
+    return computer_vs_computer_simulation<BoardType>(Agent::minimax(depth, heuristic1), Agent::minimax(depth, heuristic2), game_stats);
+}
+
+// Function for a human vs. computer game, an extra turn lets the same player (human or computer) move again
 int human_vs_computer_game()
 {
     Board board;
@@ -39,25 +109,25 @@ int human_vs_computer_game()
         if (current_player == PLAYER_1)
         {
             int human_move;
-            cout << "Your turn! Choose a bin (0 to " << NUMBER_OF_BINS - 1 << "): ";
+            cout << "Your turn! Choose a bin (0 to " << Board::NUMBER_OF_BINS - 1 << "): ";
             cin >> human_move;
 
-            while (human_move < 0 || human_move >= NUMBER_OF_BINS || board.bins[human_move] == 0)
+            while (human_move < 0 || human_move >= Board::NUMBER_OF_BINS || board.bins[human_move] == 0)
             {
                 cout << "Invalid move! Try again: ";
                 cin >> human_move;
             }
 
-            auto move_metrics = board.make_move(human_move, PLAYER_1);
-            current_player = (move_metrics.first) ? PLAYER_1 : PLAYER_2;
+            bool extra_turn = board.make_move(human_move, PLAYER_1).first;
+            current_player = next_player(PLAYER_1, extra_turn);
         }
         else
         {
             // Computer player's turn
             cout << "Computer's turn!" << endl;
             int best_move = get_best_move(board, depth, heuristic, PLAYER_2);
-            board.make_move(best_move, PLAYER_2);
-            current_player = PLAYER_1;
+            bool extra_turn = board.make_move(best_move, PLAYER_2).first;
+            current_player = next_player(PLAYER_2, extra_turn);
         }
     }
 
@@ -102,13 +172,13 @@ void update_heuristic_wins(int heuristic1, int heuristic2, bool player1_won,
         update_wins(H34, player1_won ? heuristic1 == 3 : heuristic2 == 3);
 }
 
-// Run a hundred game simulations for analysis
-void run_hundred_game_simulation()
+// Run game simulations of a Kalah variant for analysis
+template <class BoardType = Board>
+void run_game_simulation(int total_simulations, const string &report_name, const string &stats_name, const string &log_name)
 {
     int player1_wins = 0;
     int player2_wins = 0;
     int draws = 0;
-    const int total_simulations = 100;
 
     Heuristic_Pair H12(1, 2);
     Heuristic_Pair H13(1, 3);
@@ -117,7 +187,13 @@ void run_hundred_game_simulation()
     Heuristic_Pair H24(2, 4);
     Heuristic_Pair H34(3, 4);
 
-    ofstream report_file("game_report.txt");
+    ofstream report_file(report_name);
+    ofstream stats_file(stats_name); // search statistics sidecar
+    SearchStats all_games_stats;
+    stats_file << "{\"games\": [";
+    GameLogWriter game_log; // every move of every game
+    game_log.open(log_name, BoardType::NUMBER_OF_BINS, BoardType::STONES_PER_BIN);
+
     for (int i = 0; i < total_simulations; i++)
     {
         int depth = (rand() % 6) + 1;
@@ -126,28 +202,44 @@ void run_hundred_game_simulation()
 
         report_file << "depth: " << depth << ", heuristic 1: " << heuristic1 << ", heuristic 2: " << heuristic2;
 
-        int result = computer_vs_computer_simulation(depth, heuristic1, heuristic2);
+        GameStats game_stats;
+        int result = computer_vs_computer_simulation<BoardType>(depth, heuristic1, heuristic2, &game_stats);
+
+        all_games_stats.add(game_stats.totals[PLAYER_1]);
+        all_games_stats.add(game_stats.totals[PLAYER_2]);
+        stats_file << (i ? ",\n" : "\n") << "{\"depth\": " << depth << ", \"heuristic_1\": " << heuristic1
+                   << ", \"heuristic_2\": " << heuristic2 << ", \"winner\": " << (result == -1 ? 0 : result + 1) << ", ";
+        game_stats.print_json(stats_file);
+        stats_file << "}";
+        game_log.write({depth, heuristic1, heuristic2, result, game_stats.moves});
         if (result == PLAYER_1)
         {
             player1_wins++;
             report_file << ", winner: player 1" << endl;
-            report_file << "winner heuristic: " << heuristic1 << ", loser heuristic: " << heuristic2 << endl << endl;
+            report_file << "winner heuristic: " << heuristic1 << ", loser heuristic: " << heuristic2 << endl;
             update_heuristic_wins(heuristic1, heuristic2, true, H12, H13, H14, H23, H24, H34);
         }
         else if (result == PLAYER_2)
         {
             player2_wins++;
             report_file << ", winner: player 2" << endl;
-            report_file << "winner heuristic: " << heuristic2 << ", loser heuristic: " << heuristic1 << endl << endl;
+            report_file << "winner heuristic: " << heuristic2 << ", loser heuristic: " << heuristic1 << endl;
             update_heuristic_wins(heuristic1, heuristic2, false, H12, H13, H14, H23, H24, H34);
         }
         else
         {
             draws++;
-            report_file << ", match drawn" << endl << endl;
+            report_file << ", match drawn" << endl;
         }
+        game_stats.print(report_file);
+        report_file << endl;
     }
 
+    stats_file << "\n], \"totals\": ";
+    all_games_stats.print_json(stats_file);
+    stats_file << "}" << endl;
+    stats_file.close();
+
     double player1_win_percentage = (static_cast<double>(player1_wins) / total_simulations) * 100;
     double player2_win_percentage = (static_cast<double>(player2_wins) / total_simulations) * 100;
     double draw_percentage = (static_cast<double>(draws) / total_simulations) * 100;
@@ -165,5 +257,364 @@ void run_hundred_game_simulation()
     report_file << "Player 2 win percentage: " << player2_win_percentage << "%" << endl;
     report_file << "Draw percentage: " << draw_percentage << "%" << endl;
 
+    report_file << endl;
+    report_file << "Search totals - ";
+    all_games_stats.print(report_file);
+    report_file << endl;
+
+    report_file.close();
+}
+
+// Run a hundred game simulations for analysis
+void run_hundred_game_simulation()
+{
+    run_game_simulation<Board>(100, "game_report.txt", "game_report.json", "game_log.bin");
+}
+
+// Kalah variants hosted by this binary, each one with its own specialized board and search
+template <int PITS, int SEEDS, class Function>
+bool run_if_variant(int pits, int seeds, Function &function)
+{
+    if (pits != PITS || seeds != SEEDS)
+        return false;
+    function(KalahBoard<PITS, SEEDS>());
+    return true;
+}
+
+// Calling function with a default-constructed board of Kalah(pits, seeds), false if the variant is not hosted
+template <class Function>
+bool with_variant(int pits, int seeds, Function function)
+{
+    return run_if_variant<4, 3>(pits, seeds, function) || run_if_variant<4, 4>(pits, seeds, function) ||
+           run_if_variant<4, 5>(pits, seeds, function) || run_if_variant<4, 6>(pits, seeds, function) ||
+           run_if_variant<5, 3>(pits, seeds, function) || run_if_variant<5, 4>(pits, seeds, function) ||
+           run_if_variant<5, 5>(pits, seeds, function) || run_if_variant<5, 6>(pits, seeds, function) ||
+           run_if_variant<6, 3>(pits, seeds, function) || run_if_variant<6, 4>(pits, seeds, function) ||
+           run_if_variant<6, 5>(pits, seeds, function) || run_if_variant<6, 6>(pits, seeds, function);
+}
+
+// Loading the endgame database of a variant once (again after a rebuild), if it has been built
+template <class BoardType>
+void load_endgame_database(bool reload = false)
+{
+    EndgameDatabase<BoardType> &database = endgame_database<BoardType>();
+    if ((reload || !database.is_loaded()) && database.load(endgame_database_file(BoardType::NUMBER_OF_BINS)))
+        cout << "Endgame database loaded for " << BoardType::NUMBER_OF_BINS << " pits, up to "
+             << database.get_max_stones() << " stones" << endl;
+}
+
+// Loading the opening book of a variant once (again after a rebuild), if it has been built
+template <class BoardType>
+void load_opening_book(bool reload = false)
+{
+    OpeningBook<BoardType> &book = opening_book<BoardType>();
+    if ((reload || !book.is_loaded()) && book.load(opening_book_file(BoardType::NUMBER_OF_BINS, BoardType::STONES_PER_BIN)))
+        cout << "Opening book loaded for Kalah(" << BoardType::NUMBER_OF_BINS << ", " << BoardType::STONES_PER_BIN
+             << "), " << book.size() << " positions up to " << book.get_plies() << " plies at depth " << book.get_depth() << endl;
+}
+
+// Simulating games for Kalah(4, 3) through Kalah(6, 6) in one run
+void run_variant_tournament()
+{
+    int games_per_variant;
+    cout << "Games per variant: ";
+    cin >> games_per_variant;
+
+    for (int pits = 4; pits <= 6; ++pits)
+        for (int seeds = 3; seeds <= 6; ++seeds)
+            with_variant(pits, seeds, [&](auto board)
+                         {
+                             using BoardType = decltype(board);
+                             load_endgame_database<BoardType>();
+                             load_opening_book<BoardType>();
+
+                             string name = "game_report_kalah_" + to_string(pits) + "_" + to_string(seeds);
+                             cout << "Kalah(" << pits << ", " << seeds << ")..." << endl;
+                             run_game_simulation<BoardType>(games_per_variant, name + ".txt", name + ".json", name + ".bin"); });
+}
+
+// Building the endgame database offline and loading it for the search
+void build_endgame_database()
+{
+    int pits, max_stones;
+    cout << "Pits per side (4 to 6): ";
+    cin >> pits;
+    cout << "Maximum stones in play: ";
+    cin >> max_stones;
+
+    // The database only depends on the pits, the largest seed count allows the most stones
+    bool built = with_variant(pits, 6, [&](auto board)
+                              {
+                                  using BoardType = decltype(board);
+                                  string path = endgame_database_file(BoardType::NUMBER_OF_BINS);
+                                  int largest = EndgameDatabase<BoardType>::largest_max_stones();
+                                  if (max_stones < 0 || max_stones > largest)
+                                      cout << "Invalid number of stones. Please enter 0 to " << largest << " for " << BoardType::NUMBER_OF_BINS
+                                           << " pits per side." << endl;
+                                  else if (!EndgameDatabase<BoardType>::build(max_stones, path, cout))
+                                      cout << "Could not build the endgame database" << endl; });
+    if (!built)
+    {
+        cout << "Unsupported number of pits" << endl;
+        return;
+    }
+
+    for (int seeds = 3; seeds <= 6; ++seeds)
+        with_variant(pits, seeds, [&](auto board)
+                     {
+                         load_endgame_database<decltype(board)>(true); });
+}
+
+// Replaying a game log of any hosted variant and writing the analysis next to it
+void run_game_log_analysis()
+{
+    string log_name;
+    int depth, heuristic;
+    cout << "Game log file: ";
+    cin >> log_name;
+    cout << "Analysis depth: ";
+    cin >> depth;
+    cout << "Heuristic (1 to 4): ";
+    cin >> heuristic;
+
+    GameLogReader reader;
+    if (!reader.open(log_name))
+    {
+        cout << "Not a game log: " << log_name << endl;
+        return;
+    }
+
+    bool analyzed = with_variant(reader.get_bins_per_side(), reader.get_stones_per_bin(), [&](auto board)
+                                 { analyze_game_log<decltype(board)>(reader, depth, make_evaluator(heuristic), log_name + ".csv"); });
+    if (!analyzed)
+        cout << "Unsupported variant in the game log" << endl;
+}
+
+// Building the opening book offline with a deep search and loading it for the engine
+void build_opening_book()
+{
+    int pits, seeds, plies, depth, heuristic;
+    cout << "Pits per side (4 to 6): ";
+    cin >> pits;
+    cout << "Seeds per pit (3 to 6): ";
+    cin >> seeds;
+    cout << "Book plies: ";
+    cin >> plies;
+    cout << "Search depth: ";
+    cin >> depth;
+    cout << "Heuristic (1 to 4): ";
+    cin >> heuristic;
+
+    bool built = with_variant(pits, seeds, [&](auto board)
+                              {
+                                  using BoardType = decltype(board);
+                                  string path = opening_book_file(BoardType::NUMBER_OF_BINS, BoardType::STONES_PER_BIN);
+                                  if (build_opening_book<BoardType>(plies, depth, make_evaluator(heuristic), path, cout))
+                                      load_opening_book<BoardType>(true);
+                                  else
+                                      cout << "Could not build the opening book" << endl; });
+    if (!built)
+        cout << "Unsupported variant" << endl;
+}
+
+// Checking the packed sowing kernel against KalahBoard::make_move and timing both
+template <class BoardType>
+void check_and_benchmark_sowing()
+{
+    constexpr int NUMBER_OF_BINS = BoardType::NUMBER_OF_BINS;
+    constexpr int TOTAL_BINS = BoardType::TOTAL_BINS;
+    constexpr int TOTAL_STONES = BoardType::TOTAL_STONES;
+    constexpr int PLAYER_1_STORAGE = BoardType::PLAYER_1_STORAGE;
+    constexpr int PLAYER_2_STORAGE = BoardType::PLAYER_2_STORAGE;
+    using Packed = PackedBoard<BoardType>;
+
+    // Every position reachable from the start within a few plies, plus single-bin boards with 0..TOTAL_STONES stones
+    vector<BoardType> positions;
+    vector<pair<BoardType, int>> frontier(1, {BoardType(), PLAYER_1});
+    for (int ply = 0; ply < 7; ++ply)
+    {
+        vector<pair<BoardType, int>> next;
+        for (auto &[board, player] : frontier)
+        {
+            positions.push_back(board);
+            for (int i = 0; i < NUMBER_OF_BINS; ++i)
+            {
+                int bin_index = (player == PLAYER_1) ? i : NUMBER_OF_BINS + i + 1;
+                if (board.bins[bin_index] == 0)
+                    continue;
+
+                BoardType child = board;
+                bool extra_turn = child.make_move(bin_index, player).first;
+                next.push_back({child, extra_turn ? player : 1 - player});
+            }
+        }
+        frontier.swap(next);
+    }
+    for (int bin_index = 0; bin_index < TOTAL_BINS; ++bin_index)
+        for (int stones = 0; stones <= TOTAL_STONES; ++stones)
+        {
+            BoardType board;
+            fill(board.bins.begin(), board.bins.end(), 0);
+            board.bins[bin_index] = stones;
+            positions.push_back(board);
+
+            // Same with one stone everywhere else, so laps land next to non-empty opposite pits
+            fill(board.bins.begin(), board.bins.end(), 1);
+            board.bins[PLAYER_1_STORAGE] = board.bins[PLAYER_2_STORAGE] = 0;
+            board.bins[bin_index] = stones;
+            positions.push_back(board);
+        }
+
+    long long checked = 0, mismatches = 0, captures = 0, extra_turns = 0;
+    for (auto &board : positions)
+        for (int player = PLAYER_1; player <= PLAYER_2; ++player)
+            for (int bin_index = 0; bin_index < TOTAL_BINS; ++bin_index)
+            {
+                BoardType expected = board;
+                Packed packed(board);
+                auto expected_metrics = expected.make_move(bin_index, player);
+                auto packed_metrics = packed.make_move(bin_index, player);
+
+                checked++;
+                captures += expected_metrics.second > 0;
+                extra_turns += expected_metrics.first;
+                if (expected_metrics != packed_metrics || !(packed == Packed(expected)))
+                    mismatches++;
+            }
+
+    cout << "Sowing kernel check: " << checked << " moves, " << captures << " captures, " << extra_turns
+         << " extra turns, " << mismatches << " mismatches" << endl;
+
+    // Microbenchmark: legal moves from the collected positions, applied to copies
+    vector<pair<int, int>> moves; // (position, bin index) pairs
+    for (int p = 0; p < static_cast<int>(positions.size()) && p < 4096; ++p)
+        for (int i = 0; i < TOTAL_BINS; ++i)
+            if (i != PLAYER_1_STORAGE && i != PLAYER_2_STORAGE && positions[p].bins[i] > 0)
+                moves.push_back({p, i});
+    vector<Packed> packed_positions(positions.begin(), positions.end());
+
+    const int rounds = 200;
+    long long checksum = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (auto &[p, i] : moves)
+        {
+            BoardType board = positions[p];
+            checksum += board.make_move(i, i < NUMBER_OF_BINS ? PLAYER_1 : PLAYER_2).second;
+        }
+    double board_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (auto &[p, i] : moves)
+        {
+            Packed board = packed_positions[p];
+            checksum -= board.make_move(i, i < NUMBER_OF_BINS ? PLAYER_1 : PLAYER_2).second;
+        }
+    double packed_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    double total_moves = static_cast<double>(moves.size()) * rounds;
+    cout << "KalahBoard::make_move: " << total_moves / board_seconds / 1e6 << " M moves/s" << endl;
+    cout << "PackedBoard::make_move: " << total_moves / packed_seconds / 1e6 << " M moves/s" << endl;
+    if (checksum != 0)
+        cout << "Checksum mismatch: " << checksum << endl;
+}
+
+// A depth-limited search right after a timed one must visit the same nodes and pick the same move as on its own
+template <class BoardType>
+bool check_search_after_timed_search()
+{
+    // A few plies in, so the opening book does not answer
+    BoardType board;
+    int player = PLAYER_1;
+    for (int ply = 0; ply < 6 && !board.is_game_over(); ++ply)
+    {
+        int moves[MAX_NUMBER_OF_BINS];
+        order_moves(board, player, moves);
+        player = next_player(player, board.make_move(moves[0], player).first);
+    }
+
+    const int depth = 7;
+    Evaluator evaluator = make_evaluator(2);
+    int expected_move = get_best_move(board, depth, evaluator, player);
+    uint64_t expected_nodes = thread_search_stats().nodes;
+
+    get_best_move_timed(board, 0.001, evaluator, player);
+    int move = get_best_move(board, depth, evaluator, player);
+    uint64_t nodes = thread_search_stats().nodes;
+
+    bool passed = move == expected_move && nodes == expected_nodes;
+    cout << "Search after timed search check: move " << move << " (expected " << expected_move << "), " << nodes
+         << " nodes (expected " << expected_nodes << ")" << (passed ? ", passed" : ", FAILED") << endl;
+    return passed;
+}
+
+void run_sowing_check_and_benchmark()
+{
+    for (int pits = 4; pits <= 6; ++pits)
+        for (int seeds = 3; seeds <= 6; ++seeds)
+            with_variant(pits, seeds, [&](auto board)
+                         {
+                             cout << "Kalah(" << pits << ", " << seeds << ")" << endl;
+                             check_and_benchmark_sowing<decltype(board)>(); });
+    check_search_after_timed_search<Board>();
+}
+
+// MCTS against time-limited minimax with each heuristic, both sides get the same time per move
+void run_mcts_benchmark()
+{
+    int games_per_heuristic, threads;
+    double seconds;
+    cout << "Games per heuristic: ";
+    cin >> games_per_heuristic;
+    cout << "Seconds per move: ";
+    cin >> seconds;
+    cout << "MCTS threads: ";
+    cin >> threads;
+
+    ofstream report_file("mcts_report.txt");
+    for (int playouts = 0; playouts <= 1; ++playouts)
+    {
+        MctsOptions options;
+        options.seconds = seconds;
+        options.threads = max(threads, 1);
+        options.heuristic_playouts = playouts == 1;
+        options.seed = rand();
+        Agent mcts = Agent::monte_carlo(options);
+
+        for (int heuristic = 1; heuristic <= 4; ++heuristic)
+        {
+            Agent minimax = Agent::timed_minimax(seconds, heuristic);
+            int wins = 0, losses = 0, draws = 0;
+            SearchStats mcts_stats;
+
+            // Alternating sides, MCTS moves first in even games
+            for (int game = 0; game < games_per_heuristic; ++game)
+            {
+                int mcts_player = (game % 2 == 0) ? PLAYER_1 : PLAYER_2;
+                GameStats game_stats;
+                int result = (mcts_player == PLAYER_1) ? computer_vs_computer_simulation<Board>(mcts, minimax, &game_stats)
+                                                       : computer_vs_computer_simulation<Board>(minimax, mcts, &game_stats);
+                mcts_stats.add(game_stats.totals[mcts_player]);
+
+                if (result == mcts_player)
+                    wins++;
+                else if (result == -1)
+                    draws++;
+                else
+                    losses++;
+            }
+
+            double win_rate = games_per_heuristic ? (wins + 0.5 * draws) / games_per_heuristic * 100 : 0;
+            report_file << "MCTS (" << (options.heuristic_playouts ? "heuristic" : "random") << " playouts, "
+                        << options.threads << " threads) vs. minimax heuristic " << heuristic << ", " << seconds
+                        << " s/move: " << wins << " - " << losses << " - " << draws << " (win rate " << win_rate
+                        << "%), playouts/sec: " << static_cast<long long>(mcts_stats.nodes_per_second()) << endl;
+            cout << "MCTS " << (options.heuristic_playouts ? "heuristic" : "random") << " playouts vs. heuristic "
+                 << heuristic << ": win rate " << win_rate << "%, playouts/sec: "
+                 << static_cast<long long>(mcts_stats.nodes_per_second()) << endl;
+        }
+    }
     report_file.close();
 }
\ No newline at end of file
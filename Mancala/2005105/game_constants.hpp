@@ -7,17 +7,21 @@
 #include <ctime>
 #include <utility>
 #include <numeric>
+#include <cstdint>
+#include <chrono>
+#include <array>
 
 using namespace std;
 
 const int INF = numeric_limits<int>::max();
-const int NEG_INF = numeric_limits<int>::min();
+const int NEG_INF = -INF; // symmetric, so negamax can negate both bounds
 
 const int PLAYER_1 = 0;
 const int PLAYER_2 = 1;
 
-const int NUMBER_OF_BINS = 6;
-const int TOTAL_BINS = NUMBER_OF_BINS + NUMBER_OF_BINS + 2;
+// Player to move after player's move: the same player again when the last stone landed in their storage
+inline int next_player(int player, bool extra_turn) { return extra_turn ? player : 1 - player; }
 
-const int PLAYER_1_STORAGE = NUMBER_OF_BINS;
-const int PLAYER_2_STORAGE = TOTAL_BINS - 1;
\ No newline at end of file
+// Board dimensions are template parameters of KalahBoard (game_board.hpp)
+// Packed boards hold both sides and storages in 16 lanes, which caps the pits per side
+const int MAX_NUMBER_OF_BINS = 7;
\ No newline at end of file
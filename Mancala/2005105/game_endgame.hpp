@@ -0,0 +1,267 @@
+#include "game_sow.hpp"
+#include "game_mmap.hpp"
+#include <cstring>
+#include <string>
+
+// Endgame database: exact values of all positions with few stones left in the pits
+//
+// A position is stored from the side to move's point of view: its own pits first, then the opponent's.
+// The value is the best achievable (own future store gain - opponent future store gain) under perfect play.
+// Entries are int8 and indexed by the combinatorial rank of the pit configuration:
+// positions with k stones in play come after all positions with fewer stones (stars and bars ranking).
+// Values only depend on the number of pits, so one file serves every seed count of a variant.
+
+const int8_t ENDGAME_UNKNOWN = numeric_limits<int8_t>::min();
+const char ENDGAME_MAGIC[4] = {'M', 'K', 'E', 'G'};
+const uint32_t ENDGAME_VERSION = 1;
+const uint64_t ENDGAME_MAX_ENTRIES = 1ULL << 30; // one byte each, the table is built in memory
+
+struct EndgameHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t bins_per_side;
+    uint32_t max_stones;
+};
+
+inline string endgame_database_file(int bins_per_side)
+{
+    if (bins_per_side == 6)
+        return "mancala_endgame.bin";
+    return "mancala_endgame_" + to_string(bins_per_side) + ".bin";
+}
+
+template <class BoardType>
+class EndgameDatabase
+{
+    static constexpr int NUMBER_OF_BINS = BoardType::NUMBER_OF_BINS;
+    static constexpr int PLAYABLE_BINS = 2 * NUMBER_OF_BINS;
+    static constexpr int TOTAL_STONES = BoardType::TOTAL_STONES;
+
+    MappedFile file;
+    const int8_t *values = nullptr;
+    int max_stones = -1;
+
+    // Memoized exact solver used while building, layers with fewer stones are always finished first
+    static int solve(vector<int8_t> &table, const int *pits, int stones)
+    {
+        uint64_t index = rank(pits, stones);
+        if (table[index] != ENDGAME_UNKNOWN)
+            return table[index];
+
+        int own_stones = accumulate(pits, pits + NUMBER_OF_BINS, 0);
+        int value;
+        if (own_stones == 0 || own_stones == stones)
+            value = 2 * own_stones - stones; // game over, each side collects its own pits
+        else
+        {
+            value = -TOTAL_STONES - 1;
+            PackedBoard<BoardType> board;
+            for (int i = 0; i < NUMBER_OF_BINS; ++i)
+            {
+                board.bins[i] = pits[i];
+                board.bins[NUMBER_OF_BINS + 1 + i] = pits[NUMBER_OF_BINS + i];
+            }
+
+            for (int i = 0; i < NUMBER_OF_BINS; ++i)
+            {
+                if (pits[i] == 0)
+                    continue;
+
+                PackedBoard<BoardType> child = board;
+                bool extra_turn = child.make_move(i, PLAYER_1).first;
+                int gain = child.bins[BoardType::PLAYER_1_STORAGE];
+
+                int child_pits[PLAYABLE_BINS];
+                normalize_pits(child, extra_turn ? PLAYER_1 : PLAYER_2, child_pits);
+                int child_value = solve(table, child_pits, stones - gain);
+                value = max(value, extra_turn ? gain + child_value : gain - child_value);
+            }
+        }
+
+        table[index] = static_cast<int8_t>(value);
+        return value;
+    }
+
+    // Visiting every configuration of stones in pits [pit, PLAYABLE_BINS)
+    static void solve_layer(vector<int8_t> &table, int *pits, int pit, int remaining, int stones)
+    {
+        if (pit == PLAYABLE_BINS - 1)
+        {
+            pits[pit] = remaining;
+            solve(table, pits, stones);
+            return;
+        }
+        for (int s = 0; s <= remaining; ++s)
+        {
+            pits[pit] = s;
+            solve_layer(table, pits, pit + 1, remaining - s, stones);
+        }
+    }
+
+public:
+    // Binomial coefficients C(n, k) for n up to TOTAL_STONES + PLAYABLE_BINS
+    static uint64_t binomial(int n, int k)
+    {
+        static const vector<vector<uint64_t>> table = []
+        {
+            int size = TOTAL_STONES + PLAYABLE_BINS + 1;
+            vector<vector<uint64_t>> c(size, vector<uint64_t>(PLAYABLE_BINS + 1, 0));
+            for (int i = 0; i < size; ++i)
+            {
+                c[i][0] = 1;
+                for (int j = 1; j <= min(i, PLAYABLE_BINS); ++j)
+                    c[i][j] = c[i - 1][j - 1] + c[i - 1][j];
+            }
+            return c;
+        }();
+        if (k < 0 || n < k)
+            return 0;
+        return table[n][k];
+    }
+
+    // Number of positions with at most max_stones stones in play
+    static uint64_t entries(int max_stones) { return binomial(max_stones + PLAYABLE_BINS, PLAYABLE_BINS); }
+
+    // Number of positions of a table built for max_stones, also beyond TOTAL_STONES (a file built for a variant
+    // with more seeds), or ENDGAME_MAX_ENTRIES + 1 once the table would be larger than any that is built
+    static uint64_t table_entries(uint32_t max_stones)
+    {
+        uint64_t count = 1;
+        for (int j = 1; j <= PLAYABLE_BINS; ++j)
+        {
+            count = count * (max_stones + j) / j; // C(max_stones + j, j), exact at every step
+            if (count > ENDGAME_MAX_ENTRIES)
+                return ENDGAME_MAX_ENTRIES + 1;
+        }
+        return count;
+    }
+
+    // Most stones in play whose table stays within ENDGAME_MAX_ENTRIES
+    static int largest_max_stones()
+    {
+        int max_stones = 0;
+        while (max_stones < TOTAL_STONES && entries(max_stones + 1) <= ENDGAME_MAX_ENTRIES)
+            max_stones++;
+        return max_stones;
+    }
+
+    // Rank of a pit configuration among all configurations with the same number of stones,
+    // offset by the number of configurations with fewer stones
+    static uint64_t rank(const int *pits, int stones)
+    {
+        uint64_t index = binomial(stones + PLAYABLE_BINS - 1, PLAYABLE_BINS);
+        int prefix = 0;
+        for (int j = 0; j < PLAYABLE_BINS - 1; ++j)
+        {
+            prefix += pits[j];
+            index += binomial(prefix + j, j + 1);
+        }
+        return index;
+    }
+
+    // Pits of the board seen from player's side (KalahBoard or PackedBoard)
+    template <class AnyBoard>
+    static int normalize_pits(const AnyBoard &board, int player, int *pits)
+    {
+        int own = (player == PLAYER_1) ? 0 : NUMBER_OF_BINS + 1;
+        int other = (player == PLAYER_1) ? NUMBER_OF_BINS + 1 : 0;
+        int stones = 0;
+        for (int i = 0; i < NUMBER_OF_BINS; ++i)
+        {
+            pits[i] = board.bins[own + i];
+            pits[NUMBER_OF_BINS + i] = board.bins[other + i];
+            stones += pits[i] + pits[NUMBER_OF_BINS + i];
+        }
+        return stones;
+    }
+
+    bool load(const string &path)
+    {
+        values = nullptr;
+        max_stones = -1;
+        if (!file.open(path))
+            return false;
+
+        EndgameHeader header;
+        if (file.size() < sizeof(header))
+        {
+            file.close();
+            return false;
+        }
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, ENDGAME_MAGIC, 4) != 0 || header.version != ENDGAME_VERSION ||
+            header.bins_per_side != NUMBER_OF_BINS || table_entries(header.max_stones) > ENDGAME_MAX_ENTRIES ||
+            file.size() != sizeof(header) + table_entries(header.max_stones))
+        {
+            file.close();
+            return false;
+        }
+
+        // Positions are ranked by stones first, so a table for more stones starts with the one this variant needs
+        values = reinterpret_cast<const int8_t *>(file.data() + sizeof(header));
+        max_stones = min(static_cast<int>(header.max_stones), TOTAL_STONES);
+        return true;
+    }
+
+    bool is_loaded() const { return values != nullptr; }
+    int get_max_stones() const { return max_stones; }
+
+    // Exact final score (player 1 storage - player 2 storage) if the position is in the database
+    bool probe(const BoardType &board, int player, int &final_diff) const
+    {
+        if (!values)
+            return false;
+
+        int stones_in_play = TOTAL_STONES - board.bins[BoardType::PLAYER_1_STORAGE] - board.bins[BoardType::PLAYER_2_STORAGE];
+        if (stones_in_play > max_stones)
+            return false;
+
+        int pits[PLAYABLE_BINS];
+        int stones = normalize_pits(board, player, pits);
+        if (stones > max_stones)
+            return false;
+
+        int value = values[rank(pits, stones)];
+        final_diff = board.bins[BoardType::PLAYER_1_STORAGE] - board.bins[BoardType::PLAYER_2_STORAGE] +
+                     (player == PLAYER_1 ? value : -value);
+        return true;
+    }
+
+    // Building the database for all positions with up to max_stones stones in play
+    // (false without trying when the table would exceed ENDGAME_MAX_ENTRIES)
+    static bool build(int max_stones, const string &path, ostream &progress)
+    {
+        if (max_stones < 0 || max_stones > largest_max_stones())
+            return false;
+
+        vector<int8_t> table(entries(max_stones), ENDGAME_UNKNOWN);
+        int pits[PLAYABLE_BINS];
+        for (int stones = 0; stones <= max_stones; ++stones)
+        {
+            solve_layer(table, pits, 0, stones, stones);
+            progress << "Endgame layer " << stones << " done, " << entries(stones) << " positions" << endl;
+        }
+
+        ofstream output(path, ios::binary);
+        if (!output)
+            return false;
+
+        EndgameHeader header;
+        memcpy(header.magic, ENDGAME_MAGIC, 4);
+        header.version = ENDGAME_VERSION;
+        header.bins_per_side = NUMBER_OF_BINS;
+        header.max_stones = max_stones;
+        output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char *>(table.data()), table.size());
+        return static_cast<bool>(output);
+    }
+};
+
+// Shared read-only database of a variant probed by the search, empty until loaded
+template <class BoardType>
+EndgameDatabase<BoardType> &endgame_database()
+{
+    static EndgameDatabase<BoardType> database;
+    return database;
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "game_constants.hpp"
+#include <string>
+
+// Per-thread noise source for randomized play (xorshift64*)
+// Each thread keeps its own state, so evaluation never touches libc's global rand()
+inline uint64_t &evaluation_noise_state()
+{
+    thread_local uint64_t state = 0x9E3779B97F4A7C15ULL;
+    return state;
+}
+
+// Seeding the calling thread's noise source, same seed gives the same sequence
+inline void seed_evaluation_noise(uint64_t seed)
+{
+    evaluation_noise_state() = seed ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+inline uint64_t next_evaluation_noise()
+{
+    uint64_t &state = evaluation_noise_state();
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+// Heuristic weights used by Board::evaluate
+// Defaults are the means of the old random ranges (rand() % 20 + 1, % 30 + 1, % 40 + 1, % 30 + 1)
+struct Evaluator
+{
+    int heuristic;
+    int storage_weight;
+    int side_weight;
+    int extra_turn_weight;
+    int capture_weight;
+    int noise; // 0 keeps evaluation deterministic, otherwise adds uniform noise in [-noise, noise]
+
+    Evaluator(int Heuristic = 1, int Storage_weight = 10, int Side_weight = 15, int Extra_turn_weight = 20,
+              int Capture_weight = 15, int Noise = 0)
+    {
+        heuristic = Heuristic;
+        storage_weight = Storage_weight;
+        side_weight = Side_weight;
+        extra_turn_weight = Extra_turn_weight;
+        capture_weight = Capture_weight;
+        noise = Noise;
+    }
+
+    // Score from the given player's point of view, all arguments are already relative to that player
+    int score(int storage_diff, int side_diff, int another_turn, int stones_captured) const
+    {
+        int value = storage_diff;
+
+        if (heuristic >= 2)
+            value = storage_diff * storage_weight + side_diff * side_weight;
+        if (heuristic >= 3)
+            value += another_turn * extra_turn_weight;
+        if (heuristic == 4)
+            value += stones_captured * capture_weight;
+
+        if (noise > 0)
+            value += static_cast<int>(next_evaluation_noise() % (2 * noise + 1)) - noise;
+
+        return value;
+    }
+
+    // Weights block of a config, a "heuristic h" line followed by one "name value" pair per line
+    void save(ostream &output) const
+    {
+        output << "heuristic " << heuristic << endl;
+        output << "storage_weight " << storage_weight << endl;
+        output << "side_weight " << side_weight << endl;
+        output << "extra_turn_weight " << extra_turn_weight << endl;
+        output << "capture_weight " << capture_weight << endl;
+    }
+};
+
+const string WEIGHTS_FILE = "mancala_weights.txt";
+const int HEURISTIC_COUNT = 4;
+
+// Weights every evaluator of a heuristic starts from, the defaults above until a tuned config is loaded
+// Each heuristic has its own set, other heuristic numbers share the untuned defaults
+inline Evaluator &default_weights(int heuristic)
+{
+    static vector<Evaluator> weights = []
+    {
+        vector<Evaluator> all;
+        for (int h = 0; h <= HEURISTIC_COUNT; ++h)
+            all.push_back(Evaluator(h));
+        return all;
+    }();
+    return weights[(heuristic >= 1 && heuristic <= HEURISTIC_COUNT) ? heuristic : 0];
+}
+
+inline Evaluator make_evaluator(int heuristic)
+{
+    Evaluator evaluator = default_weights(heuristic);
+    evaluator.heuristic = heuristic;
+    return evaluator;
+}
+
+// Weights config written by the tuner: one block per heuristic
+inline bool save_default_weights(const string &path)
+{
+    ofstream output(path);
+    for (int h = 1; h <= HEURISTIC_COUNT; ++h)
+        default_weights(h).save(output);
+    return static_cast<bool>(output);
+}
+
+// Loading a config, the weights after a "heuristic h" line are those of heuristic h
+// Nothing changes unless the whole file is valid
+inline bool load_default_weights(const string &path)
+{
+    ifstream input(path);
+    if (!input)
+        return false;
+
+    vector<Evaluator> loaded;
+    for (int h = 0; h <= HEURISTIC_COUNT; ++h)
+        loaded.push_back(default_weights(h));
+
+    Evaluator *current = nullptr;
+    string name;
+    int value;
+    while (input >> name >> value)
+    {
+        if (name == "heuristic")
+        {
+            if (value < 1 || value > HEURISTIC_COUNT)
+                return false;
+            current = &loaded[value];
+        }
+        else if (!current)
+            return false;
+        else if (name == "storage_weight")
+            current->storage_weight = value;
+        else if (name == "side_weight")
+            current->side_weight = value;
+        else if (name == "extra_turn_weight")
+            current->extra_turn_weight = value;
+        else if (name == "capture_weight")
+            current->capture_weight = value;
+        else
+            return false;
+    }
+    if (!input.eof())
+        return false;
+
+    for (int h = 1; h <= HEURISTIC_COUNT; ++h)
+        default_weights(h) = loaded[h];
+    return true;
+}
\ No newline at end of file
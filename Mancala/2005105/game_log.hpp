@@ -0,0 +1,276 @@
+#include "game_tuner.hpp"
+#include <condition_variable>
+
+// Binary game log: a file header, then per game a fixed-size game record followed by its moves
+// Positions are not stored, replaying the moves from the start position of the variant gives them back.
+
+const char GAME_LOG_MAGIC[4] = {'M', 'K', 'G', 'L'};
+const uint32_t GAME_LOG_VERSION = 1;
+
+struct GameLogHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t bins_per_side;
+    uint32_t stones_per_bin;
+};
+
+struct LoggedGame
+{
+    uint32_t move_count;
+    int8_t winner; // PLAYER_1, PLAYER_2 or -1 for a draw
+    uint8_t depth;
+    uint8_t heuristic_1;
+    uint8_t heuristic_2;
+};
+
+struct LoggedMove
+{
+    uint8_t bin_index;
+    uint8_t player;
+    uint8_t depth;
+    uint8_t reserved;
+    uint32_t nodes;
+    uint32_t leaf_evaluations;
+    uint32_t beta_cutoffs;
+    uint32_t table_hits;
+    float seconds;
+};
+
+// One game of the log with the statistics of each move
+struct GameLogEntry
+{
+    int depth = 0;
+    int heuristic_1 = 0;
+    int heuristic_2 = 0;
+    int winner = -1;
+    vector<MoveStats> moves;
+};
+
+inline uint32_t saturate_u32(uint64_t value) { return static_cast<uint32_t>(min<uint64_t>(value, numeric_limits<uint32_t>::max())); }
+
+// Appending games from the simulation threads, a writer thread does the file output in large blocks
+class GameLogWriter
+{
+    static constexpr size_t FLUSH_BYTES = 1 << 16;
+
+    ofstream output;
+    vector<char> pending;
+    mutex buffer_mutex;
+    condition_variable wake_writer;
+    bool closing = false;
+    thread writer;
+
+    void run()
+    {
+        vector<char> writing;
+        unique_lock<mutex> lock(buffer_mutex);
+        while (true)
+        {
+            wake_writer.wait(lock, [&]
+                             { return closing || pending.size() >= FLUSH_BYTES; });
+            writing.swap(pending);
+            bool done = closing;
+            lock.unlock();
+
+            output.write(writing.data(), writing.size());
+            writing.clear();
+
+            lock.lock();
+            if (done && pending.empty())
+                break;
+        }
+    }
+
+    template <class Record>
+    static void append(vector<char> &bytes, const Record &record)
+    {
+        const char *data = reinterpret_cast<const char *>(&record);
+        bytes.insert(bytes.end(), data, data + sizeof(record));
+    }
+
+public:
+    GameLogWriter() {}
+    GameLogWriter(const GameLogWriter &) = delete;
+    GameLogWriter &operator=(const GameLogWriter &) = delete;
+    ~GameLogWriter() { close(); }
+
+    bool open(const string &path, int bins_per_side, int stones_per_bin)
+    {
+        close();
+        output.open(path, ios::binary);
+        if (!output)
+            return false;
+
+        GameLogHeader header;
+        memcpy(header.magic, GAME_LOG_MAGIC, 4);
+        header.version = GAME_LOG_VERSION;
+        header.bins_per_side = bins_per_side;
+        header.stones_per_bin = stones_per_bin;
+        output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        closing = false;
+        writer = thread(&GameLogWriter::run, this);
+        return true;
+    }
+
+    bool is_open() const { return writer.joinable(); }
+
+    void write(const GameLogEntry &entry)
+    {
+        // Encoding outside of the lock, the lock only guards the append
+        vector<char> bytes;
+        bytes.reserve(sizeof(LoggedGame) + entry.moves.size() * sizeof(LoggedMove));
+        append(bytes, LoggedGame{static_cast<uint32_t>(entry.moves.size()), static_cast<int8_t>(entry.winner),
+                                 static_cast<uint8_t>(entry.depth), static_cast<uint8_t>(entry.heuristic_1),
+                                 static_cast<uint8_t>(entry.heuristic_2)});
+        for (const MoveStats &move : entry.moves)
+            append(bytes, LoggedMove{static_cast<uint8_t>(move.bin_index), static_cast<uint8_t>(move.player),
+                                     static_cast<uint8_t>(move.depth), 0, saturate_u32(move.search.nodes),
+                                     saturate_u32(move.search.leaf_evaluations), saturate_u32(move.search.beta_cutoffs),
+                                     saturate_u32(move.search.table_hits), static_cast<float>(move.search.seconds)});
+
+        lock_guard<mutex> lock(buffer_mutex);
+        pending.insert(pending.end(), bytes.begin(), bytes.end());
+        if (pending.size() >= FLUSH_BYTES)
+            wake_writer.notify_one();
+    }
+
+    void close()
+    {
+        if (!writer.joinable())
+            return;
+        {
+            lock_guard<mutex> lock(buffer_mutex);
+            closing = true;
+        }
+        wake_writer.notify_one();
+        writer.join();
+        output.close();
+    }
+};
+
+// Reading a log one game at a time, so logs of any size stream through
+class GameLogReader
+{
+    ifstream input;
+    GameLogHeader header;
+
+public:
+    bool open(const string &path)
+    {
+        input.open(path, ios::binary);
+        if (!input.read(reinterpret_cast<char *>(&header), sizeof(header)))
+            return false;
+        return memcmp(header.magic, GAME_LOG_MAGIC, 4) == 0 && header.version == GAME_LOG_VERSION;
+    }
+
+    int get_bins_per_side() const { return header.bins_per_side; }
+    int get_stones_per_bin() const { return header.stones_per_bin; }
+
+    bool next(GameLogEntry &entry)
+    {
+        LoggedGame game;
+        if (!input.read(reinterpret_cast<char *>(&game), sizeof(game)))
+            return false;
+
+        entry.depth = game.depth;
+        entry.heuristic_1 = game.heuristic_1;
+        entry.heuristic_2 = game.heuristic_2;
+        entry.winner = game.winner;
+        entry.moves.resize(game.move_count);
+        for (MoveStats &move : entry.moves)
+        {
+            LoggedMove logged;
+            if (!input.read(reinterpret_cast<char *>(&logged), sizeof(logged)))
+                return false;
+            move.player = logged.player;
+            move.depth = logged.depth;
+            move.bin_index = logged.bin_index;
+            move.search = SearchStats();
+            move.search.nodes = logged.nodes;
+            move.search.leaf_evaluations = logged.leaf_evaluations;
+            move.search.beta_cutoffs = logged.beta_cutoffs;
+            move.search.table_hits = logged.table_hits;
+            move.search.seconds = logged.seconds;
+        }
+        return true;
+    }
+};
+
+// Logged position with the move that was played and the deeper search's answer
+struct AnalyzedPosition
+{
+    long long game;
+    int ply;
+    int player;
+    int logged_bin;
+    int deep_bin;
+    int deep_value;
+};
+
+// Re-searching every logged position at depth with all cores, the results go to a CSV file in log order
+template <class BoardType>
+void analyze_game_log(GameLogReader &reader, int depth, const Evaluator &evaluator, const string &analysis_name)
+{
+    const size_t BATCH_POSITIONS = 1 << 16;
+    int threads = max(1u, thread::hardware_concurrency());
+
+    ofstream analysis_file(analysis_name);
+    analysis_file << "game,ply,player,logged_bin,deep_bin,deep_value" << endl;
+
+    vector<pair<BoardType, AnalyzedPosition>> batch;
+    long long games = 0, positions = 0, agreements = 0;
+    auto start_time = chrono::steady_clock::now();
+
+    auto analyze_batch = [&]
+    {
+        atomic<size_t> next_position(0);
+        auto worker = [&]
+        {
+            for (size_t i = next_position++; i < batch.size(); i = next_position++)
+            {
+                AnalyzedPosition &position = batch[i].second;
+                RootResult best = iterative_deepening(batch[i].first, depth, evaluator, position.player);
+                position.deep_bin = best.bin_index;
+                position.deep_value = best.value;
+            }
+        };
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back(worker);
+        for (auto &w : workers)
+            w.join();
+
+        for (auto &[board, position] : batch)
+        {
+            analysis_file << position.game << "," << position.ply << "," << position.player + 1 << "," << position.logged_bin
+                          << "," << position.deep_bin << "," << position.deep_value << "\n";
+            agreements += position.logged_bin == position.deep_bin;
+        }
+        positions += batch.size();
+        batch.clear();
+    };
+
+    GameLogEntry entry;
+    while (reader.next(entry))
+    {
+        BoardType board;
+        for (int ply = 0; ply < static_cast<int>(entry.moves.size()); ++ply)
+        {
+            const MoveStats &move = entry.moves[ply];
+            batch.push_back({board, {games, ply, move.player, move.bin_index, -1, 0}});
+            board.make_move(move.bin_index, move.player);
+        }
+        games++;
+        if (batch.size() >= BATCH_POSITIONS)
+            analyze_batch();
+    }
+    analyze_batch();
+    analysis_file.close();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    cout << games << " games, " << positions << " positions re-searched at depth " << depth << " in " << seconds
+         << " s, logged move agrees with the deeper search in "
+         << (positions ? 100.0 * agreements / positions : 0) << "% of positions" << endl;
+}
\ No newline at end of file
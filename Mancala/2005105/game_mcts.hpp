@@ -0,0 +1,331 @@
+#include "game_algo.hpp"
+#include <mutex>
+#include <cmath>
+
+// Monte Carlo Tree Search (UCT) agent
+// Nodes live in a preallocated pool and refer to each other by index, children of a node are contiguous.
+// In parallel mode every worker selects and backs up under one lock and runs its playout outside of it;
+// a virtual loss on the selected path steers the other workers to different lines meanwhile.
+
+struct MctsOptions
+{
+    double seconds = 1.0;           // time budget per move, used when iterations is 0
+    int iterations = 0;             // fixed number of playouts per move
+    int threads = 1;                // workers sharing the tree
+    bool heuristic_playouts = true; // prefer extra turns and captures in playouts instead of uniform moves
+    double exploration = 1.4;
+    size_t max_nodes = 1 << 19;     // pool capacity, the tree stops growing when it is full
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+};
+
+// Small per-worker random source (xorshift64*)
+struct FastRandom
+{
+    uint64_t state;
+
+    explicit FastRandom(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ULL) {}
+
+    uint64_t next()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    int below(int n) { return static_cast<int>((next() >> 33) % n); }
+};
+
+template <class BoardType>
+class MctsAgent
+{
+    static constexpr int NUMBER_OF_BINS = BoardType::NUMBER_OF_BINS;
+    static constexpr uint32_t NO_NODE = numeric_limits<uint32_t>::max();
+    using Packed = PackedBoard<BoardType>;
+
+    struct Node
+    {
+        Packed board;
+        uint32_t parent;
+        uint32_t first_child;
+        uint32_t visits;       // includes the virtual losses of playouts still running
+        float wins;            // from the point of view of the player who moved into this node
+        uint8_t child_count;
+        uint8_t bin_index;     // move that led here
+        uint8_t player;        // side to move
+        uint8_t mover;         // side that made the move leading here
+        bool expanded;
+        bool terminal;
+    };
+
+    MctsOptions options;
+    vector<Node> pool;
+    vector<Node> spare_pool; // target of the subtree copy on reuse
+    size_t used = 0;
+    uint32_t root = NO_NODE;
+    mutex tree_mutex;
+    uint64_t last_playouts = 0;
+
+    uint32_t allocate(int count)
+    {
+        if (used + count > pool.size())
+            return NO_NODE;
+        uint32_t first = static_cast<uint32_t>(used);
+        used += count;
+        return first;
+    }
+
+    void init_node(Node &node, const Packed &board, uint32_t parent, int bin_index, int player, int mover)
+    {
+        node.board = board;
+        node.parent = parent;
+        node.first_child = NO_NODE;
+        node.visits = 0;
+        node.wins = 0;
+        node.child_count = 0;
+        node.bin_index = static_cast<uint8_t>(bin_index);
+        node.player = static_cast<uint8_t>(player);
+        node.mover = static_cast<uint8_t>(mover);
+        node.expanded = false;
+        node.terminal = board.is_game_over();
+    }
+
+    // Creating all children of a node at once, false if the pool is full
+    bool expand(uint32_t index)
+    {
+        Node &node = pool[index];
+        int moves[NUMBER_OF_BINS];
+        int count = legal_moves(node.board, node.player, moves);
+
+        uint32_t first = allocate(count);
+        if (first == NO_NODE)
+            return false;
+
+        for (int i = 0; i < count; ++i)
+        {
+            Packed child = node.board;
+            bool extra_turn = child.make_move(moves[i], node.player).first;
+            init_node(pool[first + i], child, index, moves[i], extra_turn ? node.player : 1 - node.player, node.player);
+        }
+        node.first_child = first;
+        node.child_count = static_cast<uint8_t>(count);
+        node.expanded = true;
+        return true;
+    }
+
+    static int legal_moves(const Packed &board, int player, int *moves)
+    {
+        int first_bin = (player == PLAYER_1) ? 0 : NUMBER_OF_BINS + 1;
+        int count = 0;
+        for (int bin_index = first_bin; bin_index < first_bin + NUMBER_OF_BINS; ++bin_index)
+            if (board.bins[bin_index] > 0)
+                moves[count++] = bin_index;
+        return count;
+    }
+
+    uint32_t select_child(const Node &node) const
+    {
+        double log_visits = log(static_cast<double>(max<uint32_t>(node.visits, 1)));
+        uint32_t best_child = node.first_child;
+        double best_score = -1;
+        for (uint32_t child = node.first_child; child < node.first_child + node.child_count; ++child)
+        {
+            const Node &candidate = pool[child];
+            if (candidate.visits == 0)
+                return child;
+            double score = candidate.wins / candidate.visits + options.exploration * sqrt(log_visits / candidate.visits);
+            if (score > best_score)
+            {
+                best_score = score;
+                best_child = child;
+            }
+        }
+        return best_child;
+    }
+
+    // Selection and expansion under the tree lock, the virtual loss is one visit without a win
+    uint32_t select_leaf()
+    {
+        uint32_t index = root;
+        pool[index].visits++;
+        while (!pool[index].terminal)
+        {
+            if (!pool[index].expanded && !expand(index))
+                break;
+            index = select_child(pool[index]);
+            pool[index].visits++;
+            if (pool[index].visits == 1)
+                break; // first visit of a new node, its playout starts here
+        }
+        return index;
+    }
+
+    void backpropagate(uint32_t index, int winner)
+    {
+        for (; index != NO_NODE; index = pool[index].parent)
+            pool[index].wins += (winner == -1) ? 0.5f : (winner == pool[index].mover ? 1.0f : 0.0f);
+    }
+
+    // Playing the game to the end, uniformly or preferring extra turns and captures
+    int playout(Packed board, int player, FastRandom &random) const
+    {
+        while (!board.is_game_over())
+        {
+            int moves[NUMBER_OF_BINS];
+            int count, tactical_moves = 0;
+            if (options.heuristic_playouts)
+                count = order_moves(board, player, moves, &tactical_moves);
+            else
+                count = legal_moves(board, player, moves);
+
+            // Heuristic playouts take an extra turn or a capture three times out of four when there is one
+            int bin_index;
+            if (tactical_moves > 0 && random.below(4) != 0)
+                bin_index = moves[random.below(tactical_moves)];
+            else
+                bin_index = moves[random.below(count)];
+
+            bool extra_turn = board.make_move(bin_index, player).first;
+            if (!extra_turn)
+                player = 1 - player;
+        }
+
+        BoardType final_board = board.to_board();
+        final_board.collect_remaining_stones();
+        return final_board.get_winner();
+    }
+
+    void worker(chrono::steady_clock::time_point deadline, uint64_t iterations, uint64_t seed, uint64_t &playouts)
+    {
+        FastRandom random(seed);
+        for (uint64_t done = 0; iterations ? done < iterations : chrono::steady_clock::now() < deadline; ++done)
+        {
+            uint32_t leaf;
+            Packed board;
+            int player;
+            {
+                lock_guard<mutex> lock(tree_mutex);
+                leaf = select_leaf();
+                board = pool[leaf].board;
+                player = pool[leaf].player;
+            }
+
+            int winner = playout(board, player, random);
+
+            {
+                lock_guard<mutex> lock(tree_mutex);
+                backpropagate(leaf, winner);
+            }
+            playouts++;
+        }
+    }
+
+    // Finding the current position among the descendants of the old root and keeping only that subtree
+    bool reuse_tree(const Packed &board, int player)
+    {
+        if (root == NO_NODE)
+            return false;
+
+        uint32_t found = NO_NODE;
+        vector<pair<uint32_t, int>> stack(1, {root, 0});
+        while (!stack.empty() && found == NO_NODE)
+        {
+            auto [index, depth] = stack.back();
+            stack.pop_back();
+            const Node &node = pool[index];
+            if (node.player == player && node.board == board)
+                found = index;
+            else if (node.expanded && depth < 4)
+                for (uint32_t child = node.first_child; child < node.first_child + node.child_count; ++child)
+                    stack.push_back({child, depth + 1});
+        }
+        if (found == NO_NODE)
+            return false;
+
+        // Copying the subtree breadth first into a fresh pool, children stay contiguous
+        vector<Node> &fresh = spare_pool;
+        fresh.resize(pool.size());
+        fresh[0] = pool[found];
+        fresh[0].parent = NO_NODE;
+        size_t fresh_used = 1;
+        for (size_t next = 0; next < fresh_used; ++next)
+        {
+            Node &node = fresh[next];
+            if (!node.expanded)
+                continue;
+            uint32_t old_first = node.first_child;
+            node.first_child = static_cast<uint32_t>(fresh_used);
+            for (int i = 0; i < node.child_count; ++i)
+            {
+                fresh[fresh_used] = pool[old_first + i];
+                fresh[fresh_used].parent = static_cast<uint32_t>(next);
+                fresh_used++;
+            }
+        }
+        pool.swap(fresh);
+        used = fresh_used;
+        root = 0;
+        return true;
+    }
+
+public:
+    explicit MctsAgent(const MctsOptions &Options = MctsOptions()) : options(Options) {}
+
+    uint64_t get_last_playouts() const { return last_playouts; }
+    size_t get_tree_size() const { return used; }
+
+    // Best move for player, searching from the subtree of the previous move when the position is in it
+    int get_best_move(const BoardType &current_board, int player)
+    {
+        Packed board(current_board);
+        if (pool.size() != options.max_nodes)
+        {
+            pool.assign(options.max_nodes, Node());
+            root = NO_NODE;
+        }
+        if (!reuse_tree(board, player))
+        {
+            used = 0;
+            root = allocate(1);
+            init_node(pool[root], board, NO_NODE, 0, player, 1 - player);
+        }
+
+        int moves[NUMBER_OF_BINS];
+        int count = legal_moves(board, player, moves);
+        if (count <= 1)
+        {
+            last_playouts = 0;
+            return count ? moves[0] : -1;
+        }
+
+        auto deadline = chrono::steady_clock::now() +
+                        chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(options.seconds));
+        int threads = max(options.threads, 1);
+        uint64_t per_thread = options.iterations ? (options.iterations + threads - 1) / threads : 0;
+        vector<uint64_t> playouts(threads, 0);
+
+        options.seed = options.seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        if (threads == 1)
+            worker(deadline, per_thread, options.seed, playouts[0]);
+        else
+        {
+            vector<thread> workers;
+            for (int t = 0; t < threads; ++t)
+                workers.emplace_back([&, t]
+                                     { worker(deadline, per_thread, options.seed + t, playouts[t]); });
+            for (auto &w : workers)
+                w.join();
+        }
+        last_playouts = accumulate(playouts.begin(), playouts.end(), uint64_t(0));
+
+        // Most visited child is the move
+        const Node &node = pool[root];
+        if (!node.expanded)
+            return moves[0];
+        uint32_t best_child = node.first_child;
+        for (uint32_t child = node.first_child; child < node.first_child + node.child_count; ++child)
+            if (pool[child].visits > pool[best_child].visits)
+                best_child = child;
+        return pool[best_child].bin_index;
+    }
+};
\ No newline at end of file
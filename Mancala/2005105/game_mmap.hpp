@@ -0,0 +1,91 @@
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MANCALA_HAS_MMAP 1
+#endif
+
+// Read-only view of a whole file
+// Memory-mapped where the platform supports it, otherwise read into a buffer once
+class MappedFile
+{
+    const unsigned char *data_ptr = nullptr;
+    size_t data_size = 0;
+    std::vector<unsigned char> buffer;
+    bool mapped = false;
+
+public:
+    MappedFile() {}
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string &path)
+    {
+        close();
+#ifdef MANCALA_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void *address = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED)
+            return false;
+        data_ptr = static_cast<const unsigned char *>(address);
+        data_size = st.st_size;
+        mapped = true;
+        return true;
+#else
+        FILE *file = fopen(path.c_str(), "rb");
+        if (!file)
+            return false;
+        fseek(file, 0, SEEK_END);
+        long length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (length <= 0)
+        {
+            fclose(file);
+            return false;
+        }
+        buffer.resize(length);
+        size_t read_bytes = fread(buffer.data(), 1, length, file);
+        fclose(file);
+        if (read_bytes != static_cast<size_t>(length))
+        {
+            buffer.clear();
+            return false;
+        }
+        data_ptr = buffer.data();
+        data_size = buffer.size();
+        return true;
+#endif
+    }
+
+    void close()
+    {
+#ifdef MANCALA_HAS_MMAP
+        if (mapped)
+            munmap(const_cast<unsigned char *>(data_ptr), data_size);
+#endif
+        mapped = false;
+        buffer.clear();
+        data_ptr = nullptr;
+        data_size = 0;
+    }
+
+    bool is_open() const { return data_ptr != nullptr; }
+    const unsigned char *data() const { return data_ptr; }
+    size_t size() const { return data_size; }
+};
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "game_board.hpp"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MANCALA_SOW_SSE2 1
+#endif
+
+// Packed board: one 8-bit lane per bin, padded to 16 lanes so the whole board fits one SIMD register
+// Lane i holds bins[i] of the board, the padding lanes stay 0
+const int PACKED_LANES = 16;
+
+// Byte mask of the lanes [first_lane, first_lane + count) that fall into 64-bit word `word`
+constexpr uint64_t lane_word_mask(int first_lane, int count, int word)
+{
+    uint64_t mask = 0;
+    for (int lane = first_lane; lane < first_lane + count; ++lane)
+        if (lane / 8 == word)
+            mask |= 0xFFULL << (8 * (lane % 8));
+    return mask;
+}
+
+template <class BoardType>
+struct alignas(16) PackedBoard
+{
+    static constexpr int NUMBER_OF_BINS = BoardType::NUMBER_OF_BINS;
+    static constexpr int TOTAL_BINS = BoardType::TOTAL_BINS;
+    static constexpr int PLAYER_1_STORAGE = BoardType::PLAYER_1_STORAGE;
+    static constexpr int PLAYER_2_STORAGE = BoardType::PLAYER_2_STORAGE;
+    static constexpr int SOWING_CYCLE = TOTAL_BINS - 1; // bins one player sows into (all but the opponent's storage)
+
+    static_assert(TOTAL_BINS <= PACKED_LANES, "board does not fit the packed lanes");
+    static_assert(BoardType::TOTAL_STONES < 256, "stone counts do not fit 8-bit lanes");
+
+    uint8_t bins[PACKED_LANES];
+
+    PackedBoard() { memset(bins, 0, sizeof(bins)); }
+
+    explicit PackedBoard(const BoardType &board)
+    {
+        memset(bins, 0, sizeof(bins));
+        for (int i = 0; i < TOTAL_BINS; ++i)
+            bins[i] = static_cast<uint8_t>(board.bins[i]);
+    }
+
+    BoardType to_board() const
+    {
+        BoardType board;
+        for (int i = 0; i < TOTAL_BINS; ++i)
+            board.bins[i] = bins[i];
+        return board;
+    }
+
+    bool operator==(const PackedBoard &other) const { return memcmp(bins, other.bins, sizeof(bins)) == 0; }
+
+    bool is_game_over() const
+    {
+        uint64_t words[2];
+        memcpy(words, bins, sizeof(words));
+        uint64_t player_1_pits = (words[0] & lane_word_mask(0, NUMBER_OF_BINS, 0)) |
+                                 (words[1] & lane_word_mask(0, NUMBER_OF_BINS, 1));
+        uint64_t player_2_pits = (words[0] & lane_word_mask(NUMBER_OF_BINS + 1, NUMBER_OF_BINS, 0)) |
+                                 (words[1] & lane_word_mask(NUMBER_OF_BINS + 1, NUMBER_OF_BINS, 1));
+        return player_1_pits == 0 || player_2_pits == 0;
+    }
+
+    pair<bool, int> make_move(int bin_index, int player);
+};
+
+// Precomputed per (player, start bin) lane masks and landing bins
+template <class BoardType>
+struct SowingTables
+{
+    static constexpr int TOTAL_BINS = BoardType::TOTAL_BINS;
+    static constexpr int SOWING_CYCLE = TOTAL_BINS - 1;
+
+    // Lanes receiving one stone from each full lap (0xFF lanes, ANDed with the lap count)
+    alignas(16) uint8_t lap_mask[2][PACKED_LANES];
+    // Lanes receiving one stone from the last partial lap of rem stones, rem in 1..SOWING_CYCLE
+    alignas(16) uint8_t remainder_mask[2][TOTAL_BINS][SOWING_CYCLE + 1][PACKED_LANES];
+    // Bin where the last stone lands
+    uint8_t last_bin[2][TOTAL_BINS][SOWING_CYCLE + 1];
+
+    SowingTables()
+    {
+        memset(this, 0, sizeof(*this));
+        for (int player = PLAYER_1; player <= PLAYER_2; ++player)
+        {
+            int opponent_storage = (player == PLAYER_1) ? BoardType::PLAYER_2_STORAGE : BoardType::PLAYER_1_STORAGE;
+            for (int i = 0; i < TOTAL_BINS; ++i)
+                lap_mask[player][i] = (i != opponent_storage) ? 0xFF : 0;
+
+            for (int start = 0; start < TOTAL_BINS; ++start)
+            {
+                int current_index = start;
+                for (int rem = 1; rem <= SOWING_CYCLE; ++rem)
+                {
+                    current_index = (current_index + 1) % TOTAL_BINS;
+                    if (current_index == opponent_storage)
+                        current_index = (current_index + 1) % TOTAL_BINS;
+
+                    memcpy(remainder_mask[player][start][rem], remainder_mask[player][start][rem - 1], PACKED_LANES);
+                    remainder_mask[player][start][rem][current_index] = 1;
+                    last_bin[player][start][rem] = current_index;
+                }
+            }
+        }
+    }
+};
+
+template <class BoardType>
+const SowingTables<BoardType> &sowing_tables()
+{
+    static const SowingTables<BoardType> tables;
+    return tables;
+}
+
+// Same rules and results as KalahBoard::make_move, without a per-stone loop:
+// full laps are one lane-wise add of the lap mask, the remainder one add of a precomputed mask
+template <class BoardType>
+pair<bool, int> PackedBoard<BoardType>::make_move(int bin_index, int player)
+{
+    if (bin_index < 0 || bin_index >= TOTAL_BINS || bins[bin_index] == 0)
+        return {false, 0};
+
+    const SowingTables<BoardType> &tables = sowing_tables<BoardType>();
+    int storage_index = (player == PLAYER_1) ? PLAYER_1_STORAGE : PLAYER_2_STORAGE;
+
+    int stones = bins[bin_index];
+    bins[bin_index] = 0;
+    int laps = (stones - 1) / SOWING_CYCLE;
+    int rem = stones - laps * SOWING_CYCLE;
+
+#ifdef MANCALA_SOW_SSE2
+    __m128i board = _mm_load_si128(reinterpret_cast<const __m128i *>(bins));
+    __m128i lap = _mm_load_si128(reinterpret_cast<const __m128i *>(tables.lap_mask[player]));
+    __m128i partial = _mm_load_si128(reinterpret_cast<const __m128i *>(tables.remainder_mask[player][bin_index][rem]));
+    board = _mm_add_epi8(board, _mm_and_si128(_mm_set1_epi8(static_cast<char>(laps)), lap));
+    board = _mm_add_epi8(board, partial);
+    _mm_store_si128(reinterpret_cast<__m128i *>(bins), board);
+#else
+    // SWAR fallback: lanes never exceed TOTAL_STONES, so the adds cannot carry into the next lane
+    uint64_t words[2], lap[2], partial[2];
+    memcpy(words, bins, sizeof(words));
+    memcpy(lap, tables.lap_mask[player], sizeof(lap));
+    memcpy(partial, tables.remainder_mask[player][bin_index][rem], sizeof(partial));
+    uint64_t lap_counts = 0x0101010101010101ULL * laps;
+    words[0] += (lap[0] & lap_counts) + partial[0];
+    words[1] += (lap[1] & lap_counts) + partial[1];
+    memcpy(bins, words, sizeof(words));
+#endif
+
+    int current_index = tables.last_bin[player][bin_index][rem];
+    int stones_captured = 0;
+
+    if ((player == PLAYER_1 && current_index < NUMBER_OF_BINS && bins[current_index] == 1) ||
+        (player == PLAYER_2 && current_index > NUMBER_OF_BINS && current_index < TOTAL_BINS - 1 && bins[current_index] == 1))
+    {
+        int capture_index = TOTAL_BINS - 2 - current_index;
+        stones_captured = bins[capture_index];
+        bins[storage_index] += stones_captured + 1;
+        bins[current_index] = bins[capture_index] = 0;
+    }
+
+    return {current_index == storage_index, stones_captured};
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "game_endgame.hpp"
+#include <cmath>
+
+// Search statistics, compiled out with -DMANCALA_SEARCH_STATS=0
+#ifndef MANCALA_SEARCH_STATS
+#define MANCALA_SEARCH_STATS 1
+#endif
+
+const bool SEARCH_STATS_ENABLED = MANCALA_SEARCH_STATS != 0;
+
+struct SearchStats
+{
+    uint64_t nodes = 0;
+    uint64_t leaf_evaluations = 0;
+    uint64_t beta_cutoffs = 0;
+    uint64_t cutoffs_by_move[MAX_NUMBER_OF_BINS] = {}; // cutoffs by ordinal of the move that caused them
+    uint64_t table_probes = 0;
+    uint64_t table_hits = 0;
+    uint64_t last_iteration_nodes = 0;     // nodes of the deepest finished iteration
+    uint64_t previous_iteration_nodes = 0; // nodes of the iteration before it
+    double seconds = 0;
+
+    void add(const SearchStats &other)
+    {
+        nodes += other.nodes;
+        leaf_evaluations += other.leaf_evaluations;
+        beta_cutoffs += other.beta_cutoffs;
+        for (int i = 0; i < MAX_NUMBER_OF_BINS; ++i)
+            cutoffs_by_move[i] += other.cutoffs_by_move[i];
+        table_probes += other.table_probes;
+        table_hits += other.table_hits;
+        last_iteration_nodes += other.last_iteration_nodes;
+        previous_iteration_nodes += other.previous_iteration_nodes;
+        seconds += other.seconds;
+    }
+
+    double nodes_per_second() const { return seconds > 0 ? nodes / seconds : 0; }
+    double cutoff_rate() const
+    {
+        uint64_t interior = nodes - leaf_evaluations - table_hits;
+        return interior ? static_cast<double>(beta_cutoffs) / interior : 0;
+    }
+    double first_move_cutoff_rate() const { return beta_cutoffs ? static_cast<double>(cutoffs_by_move[0]) / beta_cutoffs : 0; }
+    double table_hit_rate() const { return table_probes ? static_cast<double>(table_hits) / table_probes : 0; }
+    // Growth of the tree from one iteration to the next, nodes_d / nodes_(d-1) over the last two finished iterations
+    double effective_branching_factor() const
+    {
+        return previous_iteration_nodes ? static_cast<double>(last_iteration_nodes) / previous_iteration_nodes : 0;
+    }
+
+    void print(ostream &output) const
+    {
+        output << "nodes: " << nodes << ", leaf evaluations: " << leaf_evaluations << ", beta cutoffs: " << beta_cutoffs
+               << " (first move " << first_move_cutoff_rate() * 100 << "%)"
+               << ", cutoff rate: " << cutoff_rate() * 100 << "%"
+               << ", branching factor: " << effective_branching_factor()
+               << ", table hits: " << table_hits << "/" << table_probes
+               << ", nodes/sec: " << static_cast<long long>(nodes_per_second());
+    }
+
+    void print_json(ostream &output) const
+    {
+        output << "{\"nodes\": " << nodes << ", \"leaf_evaluations\": " << leaf_evaluations
+               << ", \"beta_cutoffs\": " << beta_cutoffs << ", \"cutoffs_by_move\": [";
+        for (int i = 0; i < MAX_NUMBER_OF_BINS; ++i)
+            output << (i ? ", " : "") << cutoffs_by_move[i];
+        output << "], \"cutoff_rate\": " << cutoff_rate() << ", \"table_probes\": " << table_probes
+               << ", \"table_hits\": " << table_hits << ", \"table_hit_rate\": " << table_hit_rate()
+               << ", \"effective_branching_factor\": " << effective_branching_factor()
+               << ", \"seconds\": " << seconds << ", \"nodes_per_second\": " << nodes_per_second() << "}";
+    }
+};
+
+// Counters of the search running on this thread
+inline SearchStats &thread_search_stats()
+{
+    thread_local SearchStats stats;
+    return stats;
+}
+
+inline void count_node()
+{
+    if constexpr (SEARCH_STATS_ENABLED)
+        thread_search_stats().nodes++;
+}
+
+inline void count_leaf_evaluation()
+{
+    if constexpr (SEARCH_STATS_ENABLED)
+        thread_search_stats().leaf_evaluations++;
+}
+
+inline void count_beta_cutoff(int move_ordinal)
+{
+    if constexpr (SEARCH_STATS_ENABLED)
+    {
+        thread_search_stats().beta_cutoffs++;
+        thread_search_stats().cutoffs_by_move[move_ordinal]++;
+    }
+}
+
+// Nodes of an iteration of iterative deepening that finished
+inline void count_iteration(uint64_t nodes)
+{
+    if constexpr (SEARCH_STATS_ENABLED)
+    {
+        thread_search_stats().previous_iteration_nodes = thread_search_stats().last_iteration_nodes;
+        thread_search_stats().last_iteration_nodes = nodes;
+    }
+}
+
+inline void count_table_probe(bool hit)
+{
+    if constexpr (SEARCH_STATS_ENABLED)
+    {
+        thread_search_stats().table_probes++;
+        thread_search_stats().table_hits += hit;
+    }
+}
+
+// Statistics of one get_best_move call
+struct MoveStats
+{
+    int player;
+    int depth;
+    int bin_index;
+    SearchStats search;
+};
+
+// Statistics of one game, per move and in total for each player
+struct GameStats
+{
+    vector<MoveStats> moves;
+    SearchStats totals[2];
+
+    void add_move(const MoveStats &move)
+    {
+        moves.push_back(move);
+        totals[move.player].add(move.search);
+    }
+
+    void print(ostream &output) const
+    {
+        for (int player = PLAYER_1; player <= PLAYER_2; ++player)
+        {
+            output << "player " << player + 1 << " search - ";
+            totals[player].print(output);
+            output << endl;
+        }
+    }
+
+    void print_json(ostream &output) const
+    {
+        output << "\"players\": [";
+        for (int player = PLAYER_1; player <= PLAYER_2; ++player)
+        {
+            output << (player ? ", " : "");
+            totals[player].print_json(output);
+        }
+        output << "], \"moves\": [";
+        for (size_t i = 0; i < moves.size(); ++i)
+        {
+            const MoveStats &move = moves[i];
+            output << (i ? ", " : "") << "{\"player\": " << move.player + 1 << ", \"depth\": " << move.depth
+                   << ", \"bin\": " << move.bin_index << ", \"search\": ";
+            move.search.print_json(output);
+            output << "}";
+        }
+        output << "]";
+    }
+};
\ No newline at end of file
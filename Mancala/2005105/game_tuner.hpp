@@ -0,0 +1,217 @@
+#include "game_mcts.hpp"
+#include <iomanip>
+
+// SPSA tuner of the weights of heuristics 2-4, one heuristic at a time
+// Every iteration perturbs all weights the heuristic uses at once by +-c_k, plays game pairs between the two
+// perturbed evaluators at a fixed depth (same random opening, colors swapped) and steps along the estimated
+// gradient. Game pairs are spread over all cores, each worker thread owns its boards and search state.
+
+const int TUNED_WEIGHTS = 4;
+
+// Heuristic h uses the first h weights: storage and side (2), extra turns (3), captures (4)
+inline int tuned_weight_count(int heuristic) { return min(heuristic, TUNED_WEIGHTS); }
+
+inline string tuner_checkpoint_file(int heuristic)
+{
+    return "mancala_tuner_checkpoint_" + to_string(heuristic) + ".txt";
+}
+
+struct TunerState
+{
+    int heuristic;
+    int iteration = 0;
+    double weights[TUNED_WEIGHTS];
+
+    explicit TunerState(int Heuristic = 4) : heuristic(Heuristic)
+    {
+        const Evaluator &start = default_weights(heuristic);
+        weights[0] = start.storage_weight;
+        weights[1] = start.side_weight;
+        weights[2] = start.extra_turn_weight;
+        weights[3] = start.capture_weight;
+    }
+
+    // Only the weights the heuristic uses are offset, the others keep their values
+    Evaluator evaluator(const double *offsets = nullptr) const
+    {
+        int rounded[TUNED_WEIGHTS];
+        for (int i = 0; i < TUNED_WEIGHTS; ++i)
+            rounded[i] = max(1, static_cast<int>(lround(weights[i] + (offsets && i < tuned_weight_count(heuristic) ? offsets[i] : 0))));
+        return Evaluator(heuristic, rounded[0], rounded[1], rounded[2], rounded[3]);
+    }
+
+    bool save(const string &path) const
+    {
+        ofstream output(path);
+        output << setprecision(10) << iteration;
+        for (int i = 0; i < TUNED_WEIGHTS; ++i)
+            output << " " << weights[i];
+        output << endl;
+        return static_cast<bool>(output);
+    }
+
+    bool load(const string &path)
+    {
+        ifstream input(path);
+        TunerState loaded(heuristic);
+        input >> loaded.iteration;
+        for (int i = 0; i < TUNED_WEIGHTS; ++i)
+            input >> loaded.weights[i];
+        if (!input)
+            return false;
+        *this = loaded;
+        return true;
+    }
+};
+
+// Fixed-depth game between two evaluators after a few random opening moves, winner as in Board::get_winner
+template <class BoardType>
+int play_tuning_game(const Evaluator &evaluator1, const Evaluator &evaluator2, int depth, const vector<int> &opening)
+{
+    BoardType board;
+    const Evaluator *evaluators[2] = {&evaluator1, &evaluator2};
+    int current_player = PLAYER_1;
+
+    for (int ply = 0; !board.is_game_over(); ++ply)
+    {
+        int move = (ply < static_cast<int>(opening.size())) ? opening[ply]
+                                                          : get_best_move(board, depth, *evaluators[current_player], current_player);
+        bool extra_turn = board.make_move(move, current_player).first;
+        current_player = next_player(current_player, extra_turn);
+    }
+
+    board.collect_remaining_stones();
+    return board.get_winner();
+}
+
+// Random legal moves from the start position, shared by both games of a pair
+template <class BoardType>
+vector<int> random_opening(int plies, FastRandom &random)
+{
+    BoardType board;
+    vector<int> opening;
+    int current_player = PLAYER_1;
+    for (int ply = 0; ply < plies && !board.is_game_over(); ++ply)
+    {
+        int moves[BoardType::NUMBER_OF_BINS];
+        int count = 0;
+        int first_bin = (current_player == PLAYER_1) ? 0 : BoardType::NUMBER_OF_BINS + 1;
+        for (int bin_index = first_bin; bin_index < first_bin + BoardType::NUMBER_OF_BINS; ++bin_index)
+            if (board.bins[bin_index] > 0)
+                moves[count++] = bin_index;
+
+        int move = moves[random.below(count)];
+        opening.push_back(move);
+        current_player = next_player(current_player, board.make_move(move, current_player).first);
+    }
+    return opening;
+}
+
+// Score of evaluator plus against evaluator minus over game pairs, in [-1, 1]
+template <class BoardType>
+double play_tuning_match(const Evaluator &plus, const Evaluator &minus, int depth, int game_pairs, int opening_plies,
+                         uint64_t seed, int threads)
+{
+    atomic<int> next_pair(0);
+    vector<double> scores(threads, 0);
+
+    auto worker = [&](int t)
+    {
+        for (int pair = next_pair++; pair < game_pairs; pair = next_pair++)
+        {
+            FastRandom random(seed + 0x9E3779B97F4A7C15ULL * (pair + 1));
+            vector<int> opening = random_opening<BoardType>(opening_plies, random);
+
+            int first = play_tuning_game<BoardType>(plus, minus, depth, opening);
+            int second = play_tuning_game<BoardType>(minus, plus, depth, opening);
+            scores[t] += (first == PLAYER_1) - (first == PLAYER_2);
+            scores[t] += (second == PLAYER_2) - (second == PLAYER_1);
+        }
+    };
+
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back(worker, t);
+    for (auto &w : workers)
+        w.join();
+
+    return accumulate(scores.begin(), scores.end(), 0.0) / (2.0 * max(game_pairs, 1));
+}
+
+// Tuning the weights of one heuristic from its checkpoint if there is one, writing the checkpoint after every iteration
+void run_weight_tuner()
+{
+    int heuristic, iterations, game_pairs, depth;
+    cout << "Heuristic to tune (2-4): ";
+    cin >> heuristic;
+    if (heuristic < 2 || heuristic > HEURISTIC_COUNT)
+    {
+        cout << "Invalid heuristic. Please enter 2, 3 or 4." << endl;
+        return;
+    }
+    cout << "SPSA iterations: ";
+    cin >> iterations;
+    cout << "Game pairs per iteration: ";
+    cin >> game_pairs;
+    cout << "Search depth: ";
+    cin >> depth;
+
+    int threads = max(1u, thread::hardware_concurrency());
+    const int opening_plies = 4;
+
+    // SPSA gains with Spall's exponents, a is scaled so a decisive first result moves a weight by one unit
+    const double c = 3, alpha = 0.602, gamma = 0.101;
+    const double A = 0.1 * iterations;
+    const double a = 2 * c * pow(1 + A, alpha);
+
+    const int weight_count = tuned_weight_count(heuristic);
+    TunerState state(heuristic);
+    if (state.load(tuner_checkpoint_file(heuristic)))
+        cout << "Resuming from iteration " << state.iteration << endl;
+
+    FastRandom random(static_cast<uint64_t>(time(0)) ^ (static_cast<uint64_t>(state.iteration) << 32));
+    auto start_time = chrono::steady_clock::now();
+    long long games = 0;
+
+    while (state.iteration < iterations)
+    {
+        double a_k = a / pow(state.iteration + 1 + A, alpha);
+        double c_k = c / pow(state.iteration + 1, gamma);
+
+        double delta[TUNED_WEIGHTS], plus_offsets[TUNED_WEIGHTS], minus_offsets[TUNED_WEIGHTS];
+        for (int i = 0; i < weight_count; ++i)
+        {
+            delta[i] = (random.next() & 1) ? 1 : -1;
+            plus_offsets[i] = c_k * delta[i];
+            minus_offsets[i] = -c_k * delta[i];
+        }
+
+        double result = play_tuning_match<Board>(state.evaluator(plus_offsets), state.evaluator(minus_offsets), depth,
+                                                 game_pairs, opening_plies, random.next(), threads);
+        games += 2LL * game_pairs;
+
+        for (int i = 0; i < weight_count; ++i)
+            state.weights[i] = max(1.0, state.weights[i] + a_k * result / (2 * c_k * delta[i]));
+
+        state.iteration++;
+        state.save(tuner_checkpoint_file(heuristic));
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        Evaluator current = state.evaluator();
+        cout << "Iteration " << state.iteration << ": result " << result << ", weights " << current.storage_weight
+             << " " << current.side_weight;
+        if (weight_count > 2)
+            cout << " " << current.extra_turn_weight;
+        if (weight_count > 3)
+            cout << " " << current.capture_weight;
+        cout << ", " << static_cast<long long>(games / max(seconds, 1e-9)) << " games/s" << endl;
+    }
+
+    // Only this heuristic's set changes, the file keeps the other heuristics' weights
+    Evaluator previous = default_weights(heuristic);
+    default_weights(heuristic) = state.evaluator();
+    if (save_default_weights(WEIGHTS_FILE))
+        cout << "Tuned weights of heuristic " << heuristic << " written to " << WEIGHTS_FILE << endl;
+    else
+        default_weights(heuristic) = previous;
+}
\ No newline at end of file
@@ -1,28 +1,18 @@
-#include <iostream>
-#include <vector>
-#include <queue>
-#include <map>
-#include <algorithm>
+#include "puzzle_ara.hpp"
 #include <cmath>
+#include <cerrno>
+#include <climits>
 #include <fstream>
-
-using namespace std;
-
-vector<vector<int>> goal_state = {
-    {1, 2, 3},
-    {4, 5, 6},
-    {7, 8, 0}};
-
-// Function to check if the current state is the goal state
-bool isGoalState(vector<vector<int>> &state)
-{
-    return state == goal_state;
-}
-
-// Possible moves in the puzzle for the blank tile
-// Left, Right, Down, Up
-int row_move[] = {-1, 1, 0, 0};
-int col_move[] = {0, 0, -1, 1};
+#include <sstream>
+#include <deque>
+#include <map>
+#include <chrono>
+#include <condition_variable>
+#include <random>
+#include <unordered_map>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 pair<int, int> findBlankTilePosition(const vector<vector<int>> &puzzle)
 {
@@ -42,227 +32,244 @@ pair<int, int> findBlankTilePosition(const vector<vector<int>> &puzzle)
     return {-1, -1};
 }
 
-// Function to count inversions in the puzzle
-int countInversions(const vector<int> &flat_puzzle)
-{
-    int inv_count = 0;
-    int n = flat_puzzle.size();
-    for (int i = 0; i < n - 1; i++)
-    {
-        for (int j = i + 1; j < n; j++)
-        {
-            if (flat_puzzle[i] > flat_puzzle[j])
-            {
-                inv_count++;
-            }
-        }
-    }
-    return inv_count;
-}
-
-// Function to flatten the puzzle (convert 2D vector to 1D vector)
-vector<int> flattenPuzzle(const vector<vector<int>> &puzzle)
+// Whether the tiles are 0 .. n*n-1, each once
+bool isPuzzleWellFormed(const vector<vector<int>> &puzzle)
 {
-    vector<int> flat_puzzle;
-    for (const auto &row : puzzle)
-    {
-        for (const auto &tile : row)
-        {
-            if (tile != 0)
-                flat_puzzle.push_back(tile);
-        }
-    }
-    return flat_puzzle;
+    int n = puzzle.size();
+    return count_inversions(n * n, [&](int cell)
+                            { return puzzle[cell / n][cell % n]; }) >= 0;
 }
 
 // Function to check if the puzzle is solvable
 bool isPuzzleSolvable(const vector<vector<int>> &puzzle, int blank_x)
 {
     int n = puzzle.size();
-    vector<int> flat_puzzle = flattenPuzzle(puzzle);
+    return is_solvable(n, blank_x, [&](int cell)
+                       { return puzzle[cell / n][cell % n]; });
+}
 
-    // Count the number of inversions
-    int inv_count = countInversions(flat_puzzle);
+// Solution output through one buffer: text and boards are formatted into it and written in large blocks
+class SolutionWriter
+{
+    ostream &output;
+    string buffer;
 
-    // If grid size is odd, return true if inversion count is even
-    if (n % 2 != 0)
+    void flush_if_full()
     {
-        return (inv_count % 2 == 0);
+        if (buffer.size() >= (1 << 16))
+            flush();
     }
-    else
-    {
-        // If grid size is even, find the row of the blank (0) tile from the bottom
-        int blank_row = n - blank_x;
 
-        // Check solvability for even grid size
-        if ((blank_row + inv_count) % 2 != 0)
-            return true;
-        else
-            return false;
-    }
-}
+public:
+    explicit SolutionWriter(ostream &Output) : output(Output) {}
+    ~SolutionWriter() { flush(); }
 
-// Structure to represent a node in the search tree
-struct Node
-{
-    vector<vector<int>> puzzle;
-    int blank_x, blank_y;
-    int cost;
-    int heuristic;
-    Node *parent;
+    void flush()
+    {
+        output.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
 
-    Node(vector<vector<int>> Puzzle, int X, int Y, int Cost, int Heuristic, Node *Parent = nullptr)
+    SolutionWriter &operator<<(const string &text)
     {
-        puzzle = Puzzle;
-        blank_x = X;
-        blank_y = Y;
-        cost = Cost;
-        heuristic = Heuristic;
-        parent = Parent;
+        buffer += text;
+        flush_if_full();
+        return *this;
     }
 
-    // Overloading the less than operator for priority queue
-    bool operator<(const Node &other) const
+    SolutionWriter &operator<<(long long number) { return *this << to_string(number); }
+
+    // A board row by row, * for the blank, followed by an empty line
+    template <class State>
+    void board(const State &state, int n)
     {
-        return (cost + heuristic) > (other.cost + other.heuristic);
+        for (int cell = 0; cell < n * n; ++cell)
+        {
+            int tile = state.tile(cell);
+            if (tile == 0)
+                buffer += '*';
+            else
+                buffer += to_string(tile);
+            buffer += (cell % n == n - 1) ? " \n" : " ";
+        }
+        buffer += '\n';
+        flush_if_full();
     }
 };
 
-// Function to calculate the Hamming distance heuristic
-int calculateHammingDistance(const vector<vector<int>> &state)
+// Writing a solution path with the search's counters: every board along it when dump_boards is set,
+// otherwise only the blank's moves as a U/D/L/R string
+template <class State>
+void writeSolution(const vector<State> &path, int n, long long expanded, long long generated, ostream &output_file, bool dump_boards)
 {
-    int distance = 0;
-    int n = state.size();
-
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < n; j++)
-            if (state[i][j] != 0)
-                if (state[i][j] != (i * n + j + 1))
-                    distance++;
+    SolutionWriter writer(output_file);
+    writer << "Solution found in " << static_cast<long long>(path.size()) - 1 << " moves:\n";
+    if (dump_boards)
+        for (const State &state : path)
+            writer.board(state, n);
+    else
+        writer << move_string(path, n) << "\n";
 
-    return distance;
+    writer << "Number of expanded nodes " << expanded << "\n";
+    writer << "Number of explored nodes " << generated << "\n";
 }
 
-// Function to calculate the Manhattan distance heuristic
-int calculateManhattanDistance(vector<vector<int>> &state)
+template <class State, class Heuristic>
+void solve_n_Puzzle_states(const State &start, int n, const Heuristic &heuristic, ofstream &output_file, SearchWorkspace<State> &workspace,
+                           bool dump_boards)
 {
-    int distance = 0;
-    int n = state.size();
-    for (int i = 0; i < n; i++)
-    {
-        for (int j = 0; j < n; j++)
-        {
-            if (state[i][j] != 0)
-            {
-                int targetX = (state[i][j] - 1) / n;
-                int targetY = (state[i][j] - 1) % n;
-                distance += abs(i - targetX) + abs(j - targetY);
-            }
-        }
-    }
-    return distance;
+    SearchResult result;
+    uint32_t goal_node = a_star_search(start, n, heuristic, workspace, result);
+    if (goal_node == NO_NODE)
+        return;
+
+    writeSolution(trace_path(workspace.nodes, goal_node), n, result.expanded, result.generated, output_file, dump_boards);
 }
 
-// Function to print the puzzle
-void printPuzzle(vector<vector<int>> &puzzle, ofstream &output_file)
+// States along the blank's cells of a depth-first search path
+template <class State>
+vector<State> pathOfBlankCells(const State &start, const vector<int> &cells)
 {
-    for (auto row : puzzle)
+    vector<State> path(1, start);
+    path.reserve(cells.size() + 1);
+    for (int cell : cells)
     {
-        for (auto tile : row)
-        {
-            if (tile == 0)
-                output_file << "*" << " ";
-            else
-                output_file << tile << " ";
-        }
-        output_file << endl;
+        path.push_back(path.back());
+        path.back().move_blank(cell);
     }
+    return path;
 }
 
-// Function to trace back the solution path
-void printExpandedNodes(Node *node, ofstream &output_file)
+// IDA* with an incrementally updated heuristic, same output as the A*
+template <class State, class Heuristic>
+void solve_n_Puzzle_ida(const State &start, int n, const Heuristic &heuristic, ofstream &output_file, bool dump_boards)
 {
-    if (node == nullptr)
+    PuzzleGeometry geometry(n);
+    IdaStar<State, Heuristic> ida(geometry, heuristic);
+
+    if (ida.solve(start) < 0)
         return;
-    printExpandedNodes(node->parent, output_file);
-    printPuzzle(node->puzzle, output_file);
-    output_file << endl;
+
+    writeSolution(pathOfBlankCells(start, ida.get_path()), n, ida.get_expanded(), ida.get_generated(), output_file, dump_boards);
 }
 
-void solve_n_Puzzle_extract(vector<vector<int>> &start_state, int n, pair<int, int> blank_tile_position, char method, ofstream &output_file)
+// Hash-distributed A* on all cores, same output as the A*
+template <class State, class Heuristic>
+void solve_n_Puzzle_hda(const State &start, int n, const Heuristic &heuristic, ofstream &output_file, bool dump_boards)
 {
+    HdaStar<State, Heuristic> hda(n, heuristic, max(1u, thread::hardware_concurrency()));
+
+    if (hda.solve(start) < 0)
+        return;
+
+    writeSolution(hda.get_path(), n, hda.get_expanded(), hda.get_generated(), output_file, dump_boards);
+}
 
-    // Necessary structures for the A* algorithm
-    priority_queue<Node> pq;
-    map<vector<vector<int>>, bool> visited;
+// Bidirectional MM search, same output as the A*
+template <class State, class Heuristic>
+void solve_n_Puzzle_mm(const State &start, int n, const Heuristic &heuristic, ofstream &output_file, bool dump_boards)
+{
+    MmSearch<State, Heuristic> mm(n, heuristic);
 
-    int number_of_expanded_nodes = 0;
-    int number_of_explored_nodes = 0;
+    if (mm.solve(start) < 0)
+        return;
 
-    // Initiating algorithm
-    int initial_heuristic = 0;
-    if (method == 'H')
-        initial_heuristic = calculateHammingDistance(start_state);
-    else if (method == 'M')
-        initial_heuristic = calculateManhattanDistance(start_state);
+    writeSolution(mm.get_path(), n, mm.get_expanded(), mm.get_generated(), output_file, dump_boards);
+}
 
-    Node *start_node = new Node(start_state, blank_tile_position.first, blank_tile_position.second, 0, initial_heuristic);
-    pq.push(*start_node);
+// SMA* within node_budget nodes, same output as the A*
+template <class State, class Heuristic>
+void solve_n_Puzzle_sma(const State &start, int n, const Heuristic &heuristic, ofstream &output_file, size_t node_budget, bool dump_boards)
+{
+    SmaStar<State, Heuristic> sma(n, heuristic, node_budget);
 
-    while (!pq.empty())
+    if (sma.solve(start) < 0)
     {
-        Node current = pq.top();
-        pq.pop();
-        number_of_expanded_nodes++;
+        output_file << "No solution within " << node_budget << " nodes" << endl;
+        return;
+    }
 
-        // Checking if we have reached the goal state
-        if (isGoalState(current.puzzle))
-        {
-            output_file << "Solution found in " << current.cost << " moves:\n";
-            printExpandedNodes(&current, output_file);
+    writeSolution(sma.get_path(), n, sma.get_expanded(), sma.get_generated(), output_file, dump_boards);
+}
 
-            output_file << "Number of expanded nodes " << number_of_expanded_nodes << endl;
-            output_file << "Number of explored nodes " << number_of_explored_nodes << endl;
-            return;
-        }
+// Steady clock time seconds from now, the end of time for an infinite deadline
+chrono::steady_clock::time_point deadlineAfter(double seconds)
+{
+    if (!(seconds < 1e9))
+        return chrono::steady_clock::time_point::max();
+    return chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(seconds));
+}
 
-        // Marking the current state as visited
-        visited[current.puzzle] = true;
+// Weighted A* (weight_step 0) or ARA* until the deadline: every solution found with its suboptimality
+// bound, then the best one as the A* writes it
+template <class State, class Heuristic>
+void solve_n_Puzzle_ara(const State &start, int n, const Heuristic &heuristic, ofstream &output_file, double weight, double weight_step,
+                        double deadline_seconds, bool dump_boards)
+{
+    SearchWorkspace<State> workspace;
+    AraStar<State, Heuristic> ara(n, heuristic, workspace, weight, weight_step);
 
-        // Generating all possible next moves
-        // Maximum 4 moves possible for the blank tile
-        for (int i = 0; i < 4; i++)
-        {
-            int newX = current.blank_x + row_move[i];
-            int newY = current.blank_y + col_move[i];
+    if (ara.solve(start, deadlineAfter(deadline_seconds)) < 0)
+    {
+        output_file << "No solution within " << deadline_seconds << " s" << endl;
+        return;
+    }
 
-            // Checking if the move is within bounds
-            if (newX >= 0 && newX < n && newY >= 0 && newY < n)
-            {
-                vector<vector<int>> new_puzzle = current.puzzle;
-                // Blank tile move operation \/
-                swap(new_puzzle[current.blank_x][current.blank_y], new_puzzle[newX][newY]);
-
-                // Skipping if this state has been visited
-                if (visited.find(new_puzzle) != visited.end())
-                    continue;
-
-                int newHeuristic = 0;
-                if (method == 'H')
-                    newHeuristic = calculateHammingDistance(new_puzzle);
-                else if (method == 'M')
-                    newHeuristic = calculateManhattanDistance(new_puzzle);
-
-                Node *new_node = new Node(new_puzzle, newX, newY, current.cost + 1, newHeuristic, new Node(current));
-                pq.push(*new_node);
-                number_of_explored_nodes++;
-            }
-        }
+    for (const auto &solution : ara.get_solutions())
+        output_file << "Solution of " << solution.path.size() - 1 << " moves, at most " << solution.bound << " times optimal, after "
+                    << solution.seconds << " s" << endl;
+    writeSolution(ara.get_path(), n, ara.get_expanded(), ara.get_generated(), output_file, dump_boards);
+}
+
+// Solving with the most compact state type for the board size
+// method picks the heuristic: 'H' Hamming, 'M' Manhattan, 'L' linear conflict, 'W' walking distance,
+// 'P' pattern database
+// search picks the algorithm: 'A' A*, 'I' IDA*, 'D' hash-distributed A*, 'B' bidirectional MM,
+// 'R' SMA* within node_budget nodes, 'W' weighted A* with weight, 'T' ARA* from weight down until the
+// deadline (method 'I' alone is IDA* with Manhattan)
+// dump_boards writes every board of the solution, otherwise only its moves
+void solve_n_Puzzle_extract(vector<vector<int>> &start_state, int n, char method, ofstream &output_file,
+                            char search = 'A', size_t node_budget = SMA_DEFAULT_BUDGET, bool dump_boards = true,
+                            double weight = ARA_DEFAULT_WEIGHT, double deadline_seconds = ARA_DEFAULT_DEADLINE)
+{
+    if (method == 'I')
+    {
+        method = 'M';
+        search = 'I';
     }
+
+    bool solved = with_puzzle_state(n, [&](auto state_type)
+                                    {
+                                        using State = decltype(state_type);
+                                        State start = state_from_grid<State>(start_state);
+                                        bool known = with_heuristic(n, method, [&](const auto &heuristic)
+                                                                    {
+                                                                        if (search == 'I')
+                                                                            solve_n_Puzzle_ida(start, n, heuristic, output_file, dump_boards);
+                                                                        else if (search == 'D')
+                                                                            solve_n_Puzzle_hda(start, n, heuristic, output_file, dump_boards);
+                                                                        else if (search == 'B')
+                                                                            solve_n_Puzzle_mm(start, n, heuristic, output_file, dump_boards);
+                                                                        else if (search == 'R')
+                                                                            solve_n_Puzzle_sma(start, n, heuristic, output_file, node_budget, dump_boards);
+                                                                        else if (search == 'W')
+                                                                            solve_n_Puzzle_ara(start, n, heuristic, output_file, weight, 0, deadline_seconds, dump_boards);
+                                                                        else if (search == 'T')
+                                                                            solve_n_Puzzle_ara(start, n, heuristic, output_file, weight, ARA_DEFAULT_STEP, deadline_seconds, dump_boards);
+                                                                        else
+                                                                        {
+                                                                            SearchWorkspace<State> workspace; // freed in one go when the solve ends
+                                                                            solve_n_Puzzle_states(start, n, heuristic, output_file, workspace, dump_boards);
+                                                                        } });
+                                        if (!known)
+                                            output_file << "Heuristic not available for this board" << endl; });
+    if (!solved)
+        output_file << "Puzzle too large to solve" << endl;
 }
 
 // Function to solve the n-puzzle problem using A* algorithm
-void solve_n_Puzzle(vector<vector<int>> &start_state)
+// dump_boards writes the boards along every solution, otherwise the solutions are move strings
+void solve_n_Puzzle(vector<vector<int>> &start_state, bool dump_boards = true)
 {
 
     // State size and position of the blank tile in start state
@@ -288,46 +295,693 @@ void solve_n_Puzzle(vector<vector<int>> &start_state)
     output_file << endl;
 
     output_file << "Using Hamming Distance - " << endl;
-    solve_n_Puzzle_extract(start_state, n, blank_tile_position, 'H', output_file);
+    solve_n_Puzzle_extract(start_state, n, 'H', output_file, 'A', SMA_DEFAULT_BUDGET, dump_boards);
 
     output_file << endl;
 
     output_file << "Using Manhattan Distance - " << endl;
-    solve_n_Puzzle_extract(start_state, n, blank_tile_position, 'M', output_file);
+    solve_n_Puzzle_extract(start_state, n, 'M', output_file, 'A', SMA_DEFAULT_BUDGET, dump_boards);
+
+    output_file << endl;
+
+    output_file << "Using Linear Conflict - " << endl;
+    solve_n_Puzzle_extract(start_state, n, 'L', output_file, 'A', SMA_DEFAULT_BUDGET, dump_boards);
+
+    output_file << endl;
+
+    output_file << "Using Walking Distance - " << endl;
+    solve_n_Puzzle_extract(start_state, n, 'W', output_file, 'A', SMA_DEFAULT_BUDGET, dump_boards);
+
+    output_file << endl;
+
+    output_file << "Using IDA* with Manhattan Distance - " << endl;
+    solve_n_Puzzle_extract(start_state, n, 'I', output_file, 'A', SMA_DEFAULT_BUDGET, dump_boards);
+
+    if (PatternDatabaseHeuristic::supports(n))
+    {
+        output_file << endl;
+
+        output_file << "Using IDA* with Pattern Database - " << endl;
+        solve_n_Puzzle_extract(start_state, n, 'P', output_file, 'I', SMA_DEFAULT_BUDGET, dump_boards);
+    }
 }
 
-int main()
+// Fast answers with bounded suboptimality: weighted A*, then ARA* improving its solutions until the deadline
+void solve_n_Puzzle_anytime(vector<vector<int>> &start_state, char method, double weight, double deadline_seconds, bool dump_boards)
 {
+    int n = start_state.size();
+    pair<int, int> blank_tile_position = findBlankTilePosition(start_state);
 
-    // File input stream
-    ifstream input_file("input.txt");
-    if (!input_file)
+    ofstream output_file("output.txt");
+    if (!output_file)
+        cerr << "Error opening output file" << endl;
+
+    if (!isPuzzleSolvable(start_state, blank_tile_position.first))
     {
-        cerr << "Input file not available" << endl;
-        return -1;
+        output_file << "No solution possible" << endl;
+        return;
     }
+    output_file << "The puzzle is solvable" << endl;
 
-    // Reading start_state size
-    int start_state_size;
-    input_file >> start_state_size;
+    output_file << endl;
 
-    // Reading start_state
-    vector<vector<int>> start_state(start_state_size, vector<int>(start_state_size));
+    output_file << "Using Weighted A* (weight " << weight << ") - " << endl;
+    solve_n_Puzzle_extract(start_state, n, method, output_file, 'W', SMA_DEFAULT_BUDGET, dump_boards, weight, deadline_seconds);
+
+    output_file << endl;
+
+    output_file << "Using ARA* within " << deadline_seconds << " s - " << endl;
+    solve_n_Puzzle_extract(start_state, n, method, output_file, 'T', SMA_DEFAULT_BUDGET, dump_boards, weight, deadline_seconds);
+}
+
+// Reading one board: its size, then the tiles row by row with * for the blank
+bool readPuzzle(istream &input, vector<vector<int>> &puzzle)
+{
+    int size;
+    if (!(input >> size) || size < 2)
+        return false;
+
+    puzzle.assign(size, vector<int>(size));
     string element;
-    for (int i = 0; i < start_state_size; i++)
+    for (int i = 0; i < size; i++)
     {
-        for (int j = 0; j < start_state_size; j++)
+        for (int j = 0; j < size; j++)
         {
-            input_file >> element;
+            if (!(input >> element))
+                return false;
+            // Anything but a number that fits is stored as -1, which no board accepts as a tile
+            char *end;
+            errno = 0;
+            long tile = strtol(element.c_str(), &end, 10);
             if (element == "*")
-                start_state[i][j] = 0;
+                puzzle[i][j] = 0;
+            else if (*end != '\0' || end == element.c_str() || errno == ERANGE || tile < 0 || tile > INT_MAX)
+                puzzle[i][j] = -1;
             else
-                start_state[i][j] = stoi(element);
+                puzzle[i][j] = static_cast<int>(tile);
         }
     }
+    return true;
+}
+
+// Search workspaces of one batch worker, one per state type, so every board size reuses its own
+struct BatchWorkspaces
+{
+    SearchWorkspace<PackedState> packed;
+    SearchWorkspace<ByteState<36>> medium;
+    SearchWorkspace<ByteState<256>> large;
+
+    SearchWorkspace<PackedState> &of(const PackedState &) { return packed; }
+    SearchWorkspace<ByteState<36>> &of(const ByteState<36> &) { return medium; }
+    SearchWorkspace<ByteState<256>> &of(const ByteState<256> &) { return large; }
+};
+
+// Counters of one search mode on start, search, node_budget, weight and deadline as in solve_n_Puzzle_extract
+// The solution's move string goes to solution when one is given
+template <class State, class Heuristic>
+SearchResult runSearch(const State &start, int n, const Heuristic &heuristic, char search, size_t node_budget, double weight, double deadline_seconds,
+                       SearchWorkspace<State> &workspace, string *solution = nullptr)
+{
+    SearchResult result;
+    if (search == 'I')
+    {
+        PuzzleGeometry geometry(n);
+        IdaStar<State, Heuristic> ida(geometry, heuristic);
+        result.moves = ida.solve(start);
+        result.expanded = ida.get_expanded();
+        result.generated = ida.get_generated();
+        if (solution && result.moves >= 0)
+            *solution = move_string(pathOfBlankCells(start, ida.get_path()), n);
+    }
+    else if (search == 'D')
+    {
+        HdaStar<State, Heuristic> hda(n, heuristic, max(1u, thread::hardware_concurrency()));
+        result.moves = hda.solve(start);
+        result.expanded = hda.get_expanded();
+        result.generated = hda.get_generated();
+        if (solution && result.moves >= 0)
+            *solution = move_string(hda.get_path(), n);
+    }
+    else if (search == 'B')
+    {
+        MmSearch<State, Heuristic> mm(n, heuristic);
+        result.moves = mm.solve(start);
+        result.expanded = mm.get_expanded();
+        result.generated = mm.get_generated();
+        if (solution && result.moves >= 0)
+            *solution = move_string(mm.get_path(), n);
+    }
+    else if (search == 'R')
+    {
+        SmaStar<State, Heuristic> sma(n, heuristic, node_budget);
+        result.moves = sma.solve(start);
+        result.expanded = sma.get_expanded();
+        result.generated = sma.get_generated();
+        if (solution && result.moves >= 0)
+            *solution = move_string(sma.get_path(), n);
+    }
+    else if (search == 'W' || search == 'T')
+    {
+        AraStar<State, Heuristic> ara(n, heuristic, workspace, weight, search == 'T' ? ARA_DEFAULT_STEP : 0);
+        result.moves = ara.solve(start, deadlineAfter(deadline_seconds));
+        result.expanded = ara.get_expanded();
+        result.generated = ara.get_generated();
+        result.bound = ara.get_bound();
+        if (solution && result.moves >= 0)
+            *solution = move_string(ara.get_path(), n);
+    }
+    else
+    {
+        uint32_t goal_node = a_star_search(start, n, heuristic, workspace, result);
+        if (solution && goal_node != NO_NODE)
+            *solution = move_string(trace_path(workspace.nodes, goal_node), n);
+    }
+    return result;
+}
+
+// Solving a board for its counters only, the status is solved, malformed, unsolvable, solvable (search 'S'),
+// no heuristic, too large or not found
+string solveForCounters(const vector<vector<int>> &puzzle, char method, char search, size_t node_budget, double weight,
+                        double deadline_seconds, BatchWorkspaces &workspaces, SearchResult &result, string *solution = nullptr)
+{
+    int n = puzzle.size();
+    result = SearchResult();
+    if (!isPuzzleWellFormed(puzzle))
+        return "malformed"; // a tile that is not a number, out of range or repeated
+    if (!isPuzzleSolvable(puzzle, findBlankTilePosition(puzzle).first))
+        return "unsolvable";
+    if (search == 'S')
+        return "solvable";
+
+    bool known = false;
+    bool fits = with_puzzle_state(n, [&](auto state_type)
+                                  {
+                                      using State = decltype(state_type);
+                                      State start = state_from_grid<State>(puzzle);
+                                      known = with_heuristic(n, method, [&](const auto &heuristic)
+                                                             { result = runSearch(start, n, heuristic, search, node_budget, weight, deadline_seconds, workspaces.of(start), solution); }); });
+    if (!fits)
+        return "too large";
+    if (!known)
+        return "no heuristic";
+    if (result.moves < 0)
+        return "not found"; // SMA* gives up when the node budget is too small, ARA* at its deadline
+    return "solved";
+}
+
+// Solving one batch instance into its result line (without the index), with_moves adds the solution's moves
+string solveBatchInstance(const vector<vector<int>> &puzzle, char method, char search, size_t node_budget, double weight,
+                          double deadline_seconds, BatchWorkspaces &workspaces, bool with_moves)
+{
+    auto start_time = chrono::steady_clock::now();
+    SearchResult result;
+    string solution;
+    string status = solveForCounters(puzzle, method, search, node_budget, weight, deadline_seconds, workspaces, result,
+                                     with_moves ? &solution : nullptr);
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    ostringstream line;
+    line << puzzle.size() << "," << result.moves << "," << result.bound << "," << result.expanded << "," << result.generated << "," << seconds << "," << status;
+    if (with_moves)
+        line << "," << solution;
+    return line.str();
+}
+
+// Solving every board of input on a pool of threads, one CSV line per board on output in input order,
+// written as soon as it and all boards before it are done. Boards are read while the workers solve,
+// at most a few per worker are waiting at a time.
+void solvePuzzleBatch(istream &input, ostream &output, char method, char search, int threads, size_t node_budget, double weight,
+                      double deadline_seconds, bool with_moves)
+{
+    if (method == 'I')
+    {
+        method = 'M';
+        search = 'I';
+    }
+    const size_t MAX_WAITING = 4 * threads;
+
+    deque<pair<long long, vector<vector<int>>>> waiting;
+    bool reading_done = false;
+    mutex jobs_mutex;
+    condition_variable job_added, job_taken;
+
+    map<long long, string> finished;
+    long long next_to_write = 0;
+    mutex output_mutex;
+
+    output << "index,size,moves,bound,expanded,generated,seconds,status" << (with_moves ? ",solution" : "") << endl;
+    auto start_time = chrono::steady_clock::now();
+
+    auto worker = [&]
+    {
+        BatchWorkspaces workspaces; // kept across the worker's boards
+        while (true)
+        {
+            pair<long long, vector<vector<int>>> job;
+            {
+                unique_lock<mutex> lock(jobs_mutex);
+                job_added.wait(lock, [&]
+                               { return reading_done || !waiting.empty(); });
+                if (waiting.empty())
+                    return;
+                job = move(waiting.front());
+                waiting.pop_front();
+            }
+            job_taken.notify_one();
+
+            string line = solveBatchInstance(job.second, method, search, node_budget, weight, deadline_seconds, workspaces, with_moves);
+
+            lock_guard<mutex> lock(output_mutex);
+            finished[job.first] = line;
+            bool wrote = false;
+            for (auto next = finished.find(next_to_write); next != finished.end(); next = finished.find(next_to_write))
+            {
+                output << next->first << "," << next->second << "\n";
+                finished.erase(next);
+                next_to_write++;
+                wrote = true;
+            }
+            if (wrote)
+                output.flush();
+        }
+    };
+
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back(worker);
+
+    long long boards = 0;
+    vector<vector<int>> puzzle;
+    while (readPuzzle(input, puzzle))
+    {
+        // Shared tables are loaded once, before the first board reaches a worker
+        if (boards == 0 && method == 'P' && !PatternDatabaseHeuristic::supports(puzzle.size()))
+            pattern_database().load(pattern_database_file(puzzle.size()));
+
+        unique_lock<mutex> lock(jobs_mutex);
+        job_taken.wait(lock, [&]
+                       { return waiting.size() < MAX_WAITING; });
+        waiting.push_back({boards++, puzzle});
+        lock.unlock();
+        job_added.notify_one();
+    }
+    {
+        lock_guard<mutex> lock(jobs_mutex);
+        reading_done = true;
+    }
+    job_added.notify_all();
+    for (auto &w : workers)
+        w.join();
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    cerr << boards << " boards solved in " << seconds << " s with " << threads << " threads, "
+         << (seconds > 0 ? boards / seconds : 0) << " boards/s" << endl;
+}
+
+// Board reached from the goal by a random walk of moves blank moves, never straight back
+vector<vector<int>> randomWalkPuzzle(int n, int moves, mt19937 &rng)
+{
+    vector<vector<int>> puzzle(n, vector<int>(n));
+    for (int cell = 0; cell < n * n; cell++)
+        puzzle[cell / n][cell % n] = (cell + 1) % (n * n);
+
+    int blank_x = n - 1, blank_y = n - 1, previous = -1;
+    for (int step = 0; step < moves; step++)
+    {
+        vector<int> directions;
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = blank_x + row_move[i];
+            int newY = blank_y + col_move[i];
+            if (newX >= 0 && newX < n && newY >= 0 && newY < n && newX * n + newY != previous)
+                directions.push_back(i);
+        }
+        int i = directions[rng() % directions.size()];
+        previous = blank_x * n + blank_y;
+        swap(puzzle[blank_x][blank_y], puzzle[blank_x + row_move[i]][blank_y + col_move[i]]);
+        blank_x += row_move[i];
+        blank_y += col_move[i];
+    }
+    return puzzle;
+}
+
+// Serial A* against HDA* with 1, 2, 4, ... max_threads threads on the same boards
+// The table has the total time of each thread count and its speedup over the serial solver.
+void runParallelSearchBenchmark(const vector<vector<vector<int>>> &boards, char method, int max_threads)
+{
+    vector<int> thread_counts;
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+
+    double serial_seconds = 0;
+    long long serial_expanded = 0;
+    vector<double> parallel_seconds(thread_counts.size(), 0);
+    vector<long long> parallel_expanded(thread_counts.size(), 0);
+    int boards_run = 0, mismatches = 0;
+
+    for (const vector<vector<int>> &board : boards)
+    {
+        int n = board.size();
+        if (findBlankTilePosition(board).first < 0 || !isPuzzleSolvable(board, findBlankTilePosition(board).first))
+            continue;
+
+        bool known = false;
+        with_puzzle_state(n, [&](auto state_type)
+                          {
+                              using State = decltype(state_type);
+                              State start = state_from_grid<State>(board);
+                              known = with_heuristic(n, method, [&](const auto &heuristic)
+                                                     {
+                                                         SearchWorkspace<State> workspace;
+                                                         SearchResult serial;
+                                                         auto start_time = chrono::steady_clock::now();
+                                                         a_star_search(start, n, heuristic, workspace, serial);
+                                                         serial_seconds += chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+                                                         serial_expanded += serial.expanded;
+
+                                                         for (size_t k = 0; k < thread_counts.size(); k++)
+                                                         {
+                                                             HdaStar<State, decay_t<decltype(heuristic)>> hda(n, heuristic, thread_counts[k]);
+                                                             start_time = chrono::steady_clock::now();
+                                                             int moves = hda.solve(start);
+                                                             parallel_seconds[k] += chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+                                                             parallel_expanded[k] += hda.get_expanded();
+                                                             if (moves != serial.moves || static_cast<int>(hda.get_path().size()) != moves + 1)
+                                                                 mismatches++;
+                                                         } }); });
+        if (!known)
+        {
+            cerr << "Heuristic not available for a " << n << "x" << n << " board" << endl;
+            return;
+        }
+        boards_run++;
+        cout << "Board " << boards_run << " done" << endl;
+    }
+
+    cout << boards_run << " boards, serial A* " << serial_seconds << " s, " << serial_expanded << " expanded" << endl;
+    cout << "threads,seconds,speedup,expanded" << endl;
+    for (size_t k = 0; k < thread_counts.size(); k++)
+        cout << thread_counts[k] << "," << parallel_seconds[k] << ","
+             << (parallel_seconds[k] > 0 ? serial_seconds / parallel_seconds[k] : 0) << "," << parallel_expanded[k] << endl;
+    if (mismatches)
+        cout << mismatches << " parallel solves differ from the serial solution length" << endl;
+    else
+        cout << "All parallel solutions have the serial (optimal) length" << endl;
+    cout << "(" << thread::hardware_concurrency() << " hardware threads)" << endl;
+}
+
+// Resident memory of the process in KiB from /proc (field VmRSS or VmHWM), -1 where it is not available
+long long residentMemoryKiB(const string &field)
+{
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+        if (line.rfind(field + ":", 0) == 0)
+            return stoll(line.substr(field.size() + 1));
+    return -1;
+}
+
+// Handing freed memory back and restarting the peak at the current resident size, so the peak after a
+// solve minus the resident size now is what the solve used
+long long startMemoryMeasurement()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs)
+        clear_refs << "5";
+    return residentMemoryKiB("VmRSS");
+}
+
+// Random 8-puzzles by optimal solution length: a breadth-first search from the goal gives the distance
+// of all 181440 boards, per_depth boards of every depth are drawn with a fixed seed
+vector<pair<int, vector<vector<int>>>> eightPuzzlesByDepth(int per_depth, unsigned seed)
+{
+    PuzzleGeometry geometry(3);
+    unordered_map<uint64_t, int> distance; // by tiles
+    vector<vector<PackedState>> by_depth(1, vector<PackedState>(1, goal_state_of<PackedState>(3)));
+    distance[by_depth[0][0].tiles] = 0;
+    while (true)
+    {
+        vector<PackedState> next;
+        for (const PackedState &state : by_depth.back())
+            for (int i = 0; i < geometry.neighbour_count[state.blank]; ++i)
+            {
+                PackedState moved = state;
+                moved.move_blank(geometry.neighbours[state.blank][i]);
+                if (distance.emplace(moved.tiles, static_cast<int>(by_depth.size())).second)
+                    next.push_back(moved);
+            }
+        if (next.empty())
+            break;
+        by_depth.push_back(next);
+    }
+
+    mt19937 rng(seed);
+    vector<pair<int, vector<vector<int>>>> boards;
+    for (int depth = 1; depth < static_cast<int>(by_depth.size()); ++depth)
+    {
+        shuffle(by_depth[depth].begin(), by_depth[depth].end(), rng);
+        for (int i = 0; i < min(per_depth, static_cast<int>(by_depth[depth].size())); ++i)
+            boards.push_back({depth, state_to_grid(by_depth[depth][i], 3)});
+    }
+    return boards;
+}
+
+// Korf's 15-puzzles, one per line as 16 tiles (after the instance number, if there is one), 0 for the blank
+// and the blank's goal in the top left. Turned by 180 degrees and relabeled for this solver's goal,
+// which keeps every distance.
+vector<vector<vector<int>>> readKorfInstances(istream &input)
+{
+    vector<vector<vector<int>>> boards;
+    string line;
+    while (getline(input, line))
+    {
+        istringstream numbers(line);
+        vector<int> tiles;
+        int value;
+        while (numbers >> value)
+            tiles.push_back(value);
+        if (tiles.size() == 17)
+            tiles.erase(tiles.begin());
+        if (tiles.size() != 16)
+            continue;
+
+        vector<vector<int>> board(4, vector<int>(4));
+        for (int cell = 0; cell < 16; cell++)
+            board[(15 - cell) / 4][(15 - cell) % 4] = tiles[cell] == 0 ? 0 : 16 - tiles[cell];
+        boards.push_back(board);
+    }
+    return boards;
+}
+
+// Solving every board with every available heuristic and search, one CSV row per solve with the
+// expansions, expansion rate, memory used by the solve, wall time and solution length;
+// optimal is the known solution length (-1 when unknown) and the summary counts solves that miss it
+void runBenchmarkSuite(const string &suite, const vector<pair<int, vector<vector<int>>>> &boards, const string &methods,
+                       const string &searches, size_t node_budget, ofstream &csv_file)
+{
+    if (boards.empty())
+        return;
+    int n = boards[0].second.size();
+    for (char method : methods)
+        for (char search : searches)
+        {
+            long long expanded = 0, peak = 0, misses = 0, solved = 0;
+            double seconds = 0;
+            bool available = true;
+            for (size_t i = 0; i < boards.size() && available; i++)
+            {
+                const auto &[optimal, board] = boards[i];
+                BatchWorkspaces workspaces; // fresh, so the memory of one solve is measured alone
+                SearchResult result;
+                long long resident = startMemoryMeasurement();
+                auto start_time = chrono::steady_clock::now();
+                string status = solveForCounters(board, method, search, node_budget, ARA_DEFAULT_WEIGHT, ARA_DEFAULT_DEADLINE, workspaces, result);
+                double solve_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+                long long peak_kib = resident < 0 ? -1 : max(0LL, residentMemoryKiB("VmHWM") - resident);
+
+                if (status == "no heuristic")
+                {
+                    available = false;
+                    break;
+                }
+                csv_file << suite << "," << i << "," << optimal << "," << method << "," << search << "," << result.moves << ","
+                         << result.bound << "," << result.expanded << "," << result.generated << "," << solve_seconds << ","
+                         << (solve_seconds > 0 ? result.expanded / solve_seconds : 0) << "," << peak_kib << "," << status << "\n";
+
+                expanded += result.expanded;
+                seconds += solve_seconds;
+                peak = max(peak, peak_kib);
+                solved += status == "solved";
+                misses += optimal >= 0 && result.moves != optimal;
+            }
+            csv_file.flush();
+            if (!available)
+            {
+                cout << suite << " " << method << search << ": heuristic not available for " << n << "x" << n << endl;
+                continue;
+            }
+            cout << suite << " " << method << search << ": " << solved << "/" << boards.size() << " solved, " << expanded
+                 << " expanded, " << seconds << " s, " << (seconds > 0 ? expanded / seconds : 0) << " nodes/s, peak "
+                 << peak << " KiB, " << misses << " not optimal" << endl;
+        }
+}
+
+int main(int argc, char **argv)
+{
+    // Building the pattern database of a board size: --build-pdb <n>
+    if (argc == 3 && string(argv[1]) == "--build-pdb")
+    {
+        int n = stoi(argv[2]);
+        if (default_pattern_groups(n).empty())
+        {
+            cerr << "No pattern database partition for size " << n << endl;
+            return -1;
+        }
+        if (!PatternDatabase::build(n, default_pattern_groups(n), pattern_database_file(n), cout))
+        {
+            cerr << "Error writing " << pattern_database_file(n) << endl;
+            return -1;
+        }
+        cout << "Pattern database written to " << pattern_database_file(n) << endl;
+        return 0;
+    }
+
+    // Batch mode: --batch <file or - for stdin> [method] [search] [threads] [node budget] [weight] [deadline seconds] [moves]
+    // method and search as in solve_n_Puzzle_extract, Manhattan A* and one thread per core by default;
+    // search 'S' only screens the boards for solvability, for boards of any size.
+    // The node budget of SMA* is per worker, so the memory of a batch is fixed by threads and budget.
+    // Weight and deadline (per board) are those of weighted A* and ARA*, each solution's bound is in the bound column.
+    // A last "moves" adds every solution as a U/D/L/R string of the blank's moves.
+    if (argc >= 3 && string(argv[1]) == "--batch")
+    {
+        bool with_moves = string(argv[argc - 1]) == "moves";
+        int options = with_moves ? argc - 1 : argc;
+        char method = options > 3 ? argv[3][0] : 'M';
+        char search = options > 4 ? argv[4][0] : 'A';
+        int threads = options > 5 ? stoi(argv[5]) : max(1u, thread::hardware_concurrency());
+        size_t node_budget = options > 6 ? stoull(argv[6]) : SMA_DEFAULT_BUDGET;
+        double weight = options > 7 ? stod(argv[7]) : ARA_DEFAULT_WEIGHT;
+        double deadline_seconds = options > 8 ? stod(argv[8]) : ARA_DEFAULT_DEADLINE;
+
+        if (string(argv[2]) == "-")
+            solvePuzzleBatch(cin, cout, method, search, max(1, threads), node_budget, weight, deadline_seconds, with_moves);
+        else
+        {
+            ifstream batch_file(argv[2]);
+            if (!batch_file)
+            {
+                cerr << "Batch file not available" << endl;
+                return -1;
+            }
+            solvePuzzleBatch(batch_file, cout, method, search, max(1, threads), node_budget, weight, deadline_seconds, with_moves);
+        }
+        return 0;
+    }
+
+    // Parallel search benchmark: --hda-benchmark [file or - for random 15-puzzles] [method] [max threads]
+    if (argc >= 2 && string(argv[1]) == "--hda-benchmark")
+    {
+        string board_file = argc > 2 ? argv[2] : "-";
+        char method = argc > 3 ? argv[3][0] : 'M';
+        int max_threads = argc > 4 ? stoi(argv[4]) : 32;
+
+        vector<vector<vector<int>>> boards;
+        if (board_file == "-")
+        {
+            // Seeded random walks, deep enough for a few hundred thousand A* expansions with Manhattan distance
+            mt19937 rng(318);
+            for (int i = 0; i < 10; i++)
+                boards.push_back(randomWalkPuzzle(4, 80, rng));
+        }
+        else
+        {
+            ifstream input(board_file);
+            vector<vector<int>> puzzle;
+            while (readPuzzle(input, puzzle))
+                boards.push_back(puzzle);
+        }
+
+        if (method == 'P' && !boards.empty())
+            pattern_database().load(pattern_database_file(boards[0].size()));
+        runParallelSearchBenchmark(boards, method, max_threads);
+        return 0;
+    }
+
+    // Benchmark: --benchmark <csv file> [Korf instance file or -] [methods] [searches] [8-puzzles per depth]
+    // Random 8-puzzles of every optimal length with every heuristic and search by default; Korf's 100
+    // 15-puzzles only from a supplied file, with IDA* and the linear conflict and pattern database heuristics
+    // unless methods and searches are given
+    if (argc >= 3 && string(argv[1]) == "--benchmark")
+    {
+        string korf_name = argc > 3 ? argv[3] : "-";
+        string methods = argc > 4 ? argv[4] : "";
+        string searches = argc > 5 ? argv[5] : "";
+        int per_depth = argc > 6 ? stoi(argv[6]) : 10;
+
+        ofstream csv_file(argv[2]);
+        if (!csv_file)
+        {
+            cerr << "Error opening " << argv[2] << endl;
+            return -1;
+        }
+        csv_file << "suite,instance,optimal,method,search,moves,bound,expanded,generated,seconds,nodes_per_second,peak_kib,status" << endl;
+
+        runBenchmarkSuite("8-puzzle", eightPuzzlesByDepth(per_depth, 318), methods.empty() ? "HMLW" : methods,
+                          searches.empty() ? "AIBRD" : searches, SMA_DEFAULT_BUDGET, csv_file);
+
+        if (korf_name == "-")
+            cout << "Korf's 15-puzzles skipped, no instance file given" << endl;
+        else
+        {
+            ifstream korf_file(korf_name);
+            vector<pair<int, vector<vector<int>>>> korf;
+            for (auto &board : readKorfInstances(korf_file))
+                korf.push_back({-1, board});
+            if (korf.empty())
+                cout << "No 15-puzzles read from " << korf_name << endl;
+            pattern_database().load(pattern_database_file(4));
+            runBenchmarkSuite("korf100", korf, methods.empty() ? "LP" : methods, searches.empty() ? "I" : searches,
+                              SMA_DEFAULT_BUDGET, csv_file);
+        }
+        return 0;
+    }
+
+    // File input stream
+    ifstream input_file("input.txt");
+    if (!input_file)
+    {
+        cerr << "Input file not available" << endl;
+        return -1;
+    }
+
+    // Reading start_state
+    vector<vector<int>> start_state;
+    if (!readPuzzle(input_file, start_state))
+    {
+        cerr << "Invalid input" << endl;
+        return -1;
+    }
 
     input_file.close();
 
-    solve_n_Puzzle(start_state);
+    // Pattern database of this size, if one has been built
+    pattern_database().load(pattern_database_file(start_state.size()));
+
+    // Anytime mode: --anytime [deadline seconds] [start weight] [method], weighted A* and ARA* only,
+    // with the pattern database when one is built for the size and linear conflict otherwise
+    if (argc >= 2 && string(argv[1]) == "--anytime")
+    {
+        double deadline_seconds = argc > 2 ? stod(argv[2]) : ARA_DEFAULT_DEADLINE;
+        double weight = argc > 3 ? stod(argv[3]) : ARA_DEFAULT_WEIGHT;
+        char method = argc > 4 ? argv[4][0] : (PatternDatabaseHeuristic::supports(start_state.size()) ? 'P' : 'L');
+        solve_n_Puzzle_anytime(start_state, method, weight, deadline_seconds, true);
+        return 0;
+    }
+
+    // --moves writes the solutions as move strings instead of every board along them
+    solve_n_Puzzle(start_state, !(argc == 2 && string(argv[1]) == "--moves"));
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "puzzle_sma.hpp"
+#include <chrono>
+#include <cmath>
+
+// Weighted A* and ARA* (anytime repairing A*, Likhachev et al.): states are ordered by g + w * h, so the
+// first solution comes fast and is at most w times longer than optimal. ARA* then lowers w and repairs
+// the search instead of restarting it: only states whose g improved after they were expanded (INCONS)
+// are queued again. Every solution comes with a bound min(w, g(goal) / lowest g + h still queued).
+// The search stops at the optimal solution (bound 1) or at the deadline with the best one so far.
+
+const double ARA_DEFAULT_WEIGHT = 3.0;
+const double ARA_DEFAULT_STEP = 0.5;
+const double ARA_DEFAULT_DEADLINE = 10.0; // seconds
+
+// One solution of an anytime search, at most bound times longer than an optimal one
+template <class State>
+struct AnytimeSolution
+{
+    vector<State> path;
+    double bound;
+    double seconds; // since the search started
+    long long expanded;
+};
+
+template <class State, class Heuristic>
+class AraStar
+{
+    // Weights in fixed point, priorities stay integers for the bucket queue
+    static const int SCALE = 16;
+
+    enum Mark : uint8_t
+    {
+        SEEN,   // in no list, g is final for the current weight
+        OPEN,   // queued
+        CLOSED, // expanded with the current weight
+        INCONS  // expanded with the current weight, g improved since
+    };
+
+    int n;
+    const Heuristic &heuristic;
+    SearchWorkspace<State> &workspace;
+    int start_weight;
+    int weight_step;
+    State goal;
+    uint32_t goal_node = NO_NODE;
+    vector<Mark> marks; // by node
+    vector<AnytimeSolution<State>> solutions;
+    long long expanded = 0;
+    long long generated = 0;
+
+    int priority(uint32_t node, int weight) const
+    {
+        return SCALE * workspace.nodes[node].cost + weight * workspace.nodes[node].heuristic;
+    }
+
+    // Expanding by priority until the goal's priority is the lowest, false when the deadline passed first
+    bool improve_path(int weight, chrono::steady_clock::time_point deadline)
+    {
+        SearchArena<SearchNode<State>> &nodes = workspace.nodes;
+        BucketQueue &open = workspace.open;
+        long long steps = 0;
+        while (!open.empty())
+        {
+            int key;
+            uint32_t current = open.top(key);
+            if (marks[current] != OPEN || key != priority(current, weight))
+            {
+                open.pop(key); // outdated entry
+                continue;
+            }
+            if (goal_node != NO_NODE && priority(goal_node, weight) <= key)
+                return true;
+            if ((++steps & 255) == 0 && chrono::steady_clock::now() >= deadline)
+                return false;
+
+            open.pop(key);
+            marks[current] = CLOSED;
+            expanded++;
+
+            int blank = nodes[current].state.blank;
+            int new_cost = nodes[current].cost + 1;
+            for (int i = 0; i < 4; i++)
+            {
+                int x = blank / n + row_move[i];
+                int y = blank % n + col_move[i];
+                if (x < 0 || x >= n || y < 0 || y >= n)
+                    continue;
+
+                State new_state = nodes[current].state;
+                int new_heuristic = heuristic.after_move(new_state, nodes[current].heuristic, new_state.tile(x * n + y), x * n + y, blank);
+                new_state.move_blank(x * n + y);
+
+                uint32_t child = workspace.table.find(new_state, nodes);
+                if (child == NO_NODE)
+                {
+                    child = nodes.push_back({new_state, new_cost, new_heuristic, current, false});
+                    workspace.table.insert(child, nodes);
+                    marks.push_back(SEEN);
+                }
+                else if (nodes[child].cost <= new_cost)
+                    continue;
+                else
+                {
+                    nodes[child].cost = new_cost;
+                    nodes[child].parent = current;
+                }
+                generated++;
+
+                if (new_heuristic == 0 && new_state == goal)
+                    goal_node = child;
+                if (marks[child] == CLOSED || marks[child] == INCONS)
+                    marks[child] = INCONS;
+                else
+                {
+                    marks[child] = OPEN;
+                    open.push(child, priority(child, weight));
+                }
+            }
+        }
+        return true;
+    }
+
+public:
+    // weight_step 0 is plain weighted A*, one solution with bound start_weight at most
+    AraStar(int N, const Heuristic &Heuristic_, SearchWorkspace<State> &Workspace, double start_weight_ = ARA_DEFAULT_WEIGHT,
+            double weight_step_ = ARA_DEFAULT_STEP)
+        : n(N), heuristic(Heuristic_), workspace(Workspace),
+          start_weight(max(SCALE, static_cast<int>(lround(start_weight_ * SCALE)))),
+          weight_step(max(0, static_cast<int>(lround(weight_step_ * SCALE))))
+    {
+    }
+
+    // Length of the best solution found before the deadline, -1 if there is none
+    int solve(const State &start, chrono::steady_clock::time_point deadline)
+    {
+        auto start_time = chrono::steady_clock::now();
+        SearchArena<SearchNode<State>> &nodes = workspace.nodes;
+        workspace.clear();
+        marks.clear();
+        solutions.clear();
+        expanded = generated = 0;
+        goal = goal_state_of<State>(n);
+        goal_node = NO_NODE;
+
+        uint32_t start_node = nodes.push_back({start, 0, heuristic.evaluate(start), NO_NODE, false});
+        workspace.table.insert(start_node, nodes);
+        marks.push_back(OPEN);
+        if (start == goal)
+            goal_node = start_node;
+
+        int weight = start_weight;
+        workspace.open.push(start_node, priority(start_node, weight));
+        while (improve_path(weight, deadline) && goal_node != NO_NODE)
+        {
+            // Lowest g + h still queued or inconsistent bounds the optimal length from below
+            int lowest = INT_MAX;
+            for (uint32_t node = 0; node < marks.size(); ++node)
+                if (marks[node] == OPEN || marks[node] == INCONS)
+                    lowest = min(lowest, nodes[node].cost + nodes[node].heuristic);
+            double bound = static_cast<double>(weight) / SCALE;
+            if (lowest == INT_MAX || nodes[goal_node].cost <= lowest)
+                bound = 1.0;
+            else
+                bound = min(bound, static_cast<double>(nodes[goal_node].cost) / lowest);
+
+            vector<State> path = trace_path(nodes, goal_node);
+            if (solutions.empty() || path.size() < solutions.back().path.size() || bound < solutions.back().bound)
+                solutions.push_back({path, bound, chrono::duration<double>(chrono::steady_clock::now() - start_time).count(), expanded});
+            if (bound <= 1.0 || weight_step == 0 || weight == SCALE)
+                break;
+
+            // Next weight below the bound already proven, queued and inconsistent states get its priorities
+            weight = max(SCALE, min(weight - weight_step, static_cast<int>(floor(bound * SCALE))));
+            workspace.open.clear();
+            for (uint32_t node = 0; node < marks.size(); ++node)
+                if (marks[node] == OPEN || marks[node] == INCONS)
+                {
+                    marks[node] = OPEN;
+                    workspace.open.push(node, priority(node, weight));
+                }
+                else
+                    marks[node] = SEEN;
+        }
+        return solutions.empty() ? -1 : static_cast<int>(solutions.back().path.size()) - 1;
+    }
+
+    // Solutions in the order they were found, each shorter or with a tighter bound than the one before
+    const vector<AnytimeSolution<State>> &get_solutions() const { return solutions; }
+    vector<State> get_path() const { return solutions.empty() ? vector<State>() : solutions.back().path; }
+    double get_bound() const { return solutions.empty() ? 0 : solutions.back().bound; }
+    long long get_expanded() const { return expanded; }
+    long long get_generated() const { return generated; }
+};
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "puzzle_ida.hpp"
+
+// Counters of one solve
+struct SearchResult
+{
+    int moves = -1; // -1 when no solution was found
+    long long expanded = 0;
+    long long generated = 0;
+    double bound = 1; // the solution is at most bound times longer than optimal, 1 for the optimal searches
+};
+
+// A* over the workspace's search graph, returns the goal node (NO_NODE if the goal is unreachable)
+// Every state has one node, a better path to an open state updates it and pushes it again
+template <class State, class Heuristic>
+uint32_t a_star_search(const State &start, int n, const Heuristic &heuristic, SearchWorkspace<State> &workspace, SearchResult &result)
+{
+    const State goal = goal_state_of<State>(n);
+
+    // Structures left over from the previous solve of the workspace
+    workspace.clear();
+    SearchArena<SearchNode<State>> &nodes = workspace.nodes;
+    StateTable<State> &table = workspace.table;
+    BucketQueue &open = workspace.open;
+    result = SearchResult();
+
+    uint32_t start_node = nodes.push_back({start, 0, heuristic.evaluate(start), NO_NODE, false});
+    table.insert(start_node, nodes);
+    open.push(start_node, nodes[start_node].heuristic);
+
+    while (!open.empty())
+    {
+        int f;
+        uint32_t current = open.pop(f);
+
+        // Skipping outdated entries of nodes that were improved or already expanded
+        if (nodes[current].closed || f != nodes[current].cost + nodes[current].heuristic)
+            continue;
+        result.expanded++;
+
+        if (nodes[current].state == goal)
+        {
+            result.moves = nodes[current].cost;
+            return current;
+        }
+        nodes[current].closed = true;
+
+        // Maximum 4 moves possible for the blank tile
+        int blank_x = nodes[current].state.blank / n;
+        int blank_y = nodes[current].state.blank % n;
+        int new_cost = nodes[current].cost + 1;
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = blank_x + row_move[i];
+            int newY = blank_y + col_move[i];
+            if (newX < 0 || newX >= n || newY < 0 || newY >= n)
+                continue;
+
+            State new_state = nodes[current].state;
+            int new_heuristic = heuristic.after_move(new_state, nodes[current].heuristic, new_state.tile(newX * n + newY),
+                                                     newX * n + newY, new_state.blank);
+            new_state.move_blank(newX * n + newY);
+
+            uint32_t child = table.find(new_state, nodes);
+            if (child == NO_NODE)
+            {
+                child = nodes.push_back({new_state, new_cost, new_heuristic, current, false});
+                table.insert(child, nodes);
+            }
+            else if (nodes[child].cost <= new_cost)
+                continue;
+            else
+            {
+                // Decrease-key: cheaper path to a known state, reopened if it was closed
+                // (never happens with a consistent heuristic)
+                nodes[child].cost = new_cost;
+                nodes[child].parent = current;
+                nodes[child].closed = false;
+            }
+
+            open.push(child, new_cost + nodes[child].heuristic);
+            result.generated++;
+        }
+    }
+    return NO_NODE;
+}
+
+// States from the start to node, following the parent links in a loop
+template <class State>
+vector<State> trace_path(const SearchArena<SearchNode<State>> &nodes, uint32_t node)
+{
+    vector<State> path;
+    for (; node != NO_NODE; node = nodes[node].parent)
+        path.push_back(nodes[node].state);
+    reverse(path.begin(), path.end());
+    return path;
+}
\ No newline at end of file
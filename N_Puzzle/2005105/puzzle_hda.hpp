@@ -0,0 +1,360 @@
+#include "puzzle_astar.hpp"
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <chrono>
+
+// Hash-distributed A* (HDA*): every state is owned by one thread, picked from its hash, and only the owner
+// keeps its node, checks it for duplicates and expands it. Children of other threads are sent to their owner
+// in batches through lock-free queues. Each thread runs best-first on its own open list.
+//
+// A found goal only gives an upper bound. Threads keep expanding until no open node anywhere has f below it,
+// so the solution is optimal with an admissible heuristic. The search ends when no thread is working
+// and no batch is in flight: both are counted in one atomic counter, which can only reach 0 once everything
+// is done, since a batch is counted before it is sent and its receiver counts itself busy before the batch
+// is uncounted.
+
+template <class State>
+struct HdaMessage
+{
+    State state;
+    int cost;
+    int heuristic;
+    uint32_t parent;
+    uint16_t parent_owner;
+};
+
+template <class State>
+struct HdaNode
+{
+    State state;
+    int cost;
+    int heuristic;
+    uint32_t parent; // node index in the parent_owner thread, NO_NODE for the start
+    uint16_t parent_owner;
+    bool closed;
+};
+
+// Multiple producer, single consumer queue of message batches (Vyukov's intrusive queue)
+// Producers only exchange the head, the consumer alone walks the tail.
+template <class Message>
+class MessageQueue
+{
+public:
+    struct Batch
+    {
+        atomic<Batch *> next{nullptr};
+        vector<Message> messages;
+    };
+
+private:
+    atomic<Batch *> head;
+    Batch *tail;
+    Batch stub;
+
+public:
+    MessageQueue() : head(&stub), tail(&stub) {}
+    MessageQueue(const MessageQueue &) = delete;
+    MessageQueue &operator=(const MessageQueue &) = delete;
+
+    ~MessageQueue()
+    {
+        while (Batch *batch = pop())
+            delete batch;
+    }
+
+    void push(Batch *batch)
+    {
+        batch->next.store(nullptr, memory_order_relaxed);
+        Batch *previous = head.exchange(batch, memory_order_acq_rel);
+        previous->next.store(batch, memory_order_release);
+    }
+
+    // Oldest batch, nullptr if none is there yet (a push in progress shows up on a later call)
+    Batch *pop()
+    {
+        Batch *first = tail;
+        Batch *next = first->next.load(memory_order_acquire);
+        if (first == &stub)
+        {
+            if (next == nullptr)
+                return nullptr;
+            tail = next;
+            first = next;
+            next = next->next.load(memory_order_acquire);
+        }
+        if (next != nullptr)
+        {
+            tail = next;
+            return first;
+        }
+        if (first != head.load(memory_order_acquire))
+            return nullptr;
+        push(&stub);
+        next = first->next.load(memory_order_acquire);
+        if (next == nullptr)
+            return nullptr;
+        tail = next;
+        return first;
+    }
+};
+
+template <class State, class Heuristic>
+class HdaStar
+{
+    typedef HdaMessage<State> Message;
+    typedef typename MessageQueue<Message>::Batch Batch;
+
+    static const size_t BATCH_MESSAGES = 64;
+    static const int FLUSH_EXPANSIONS = 128; // a partly filled batch waits at most this many expansions
+    static const int IDLE_POLLS = 64;
+
+    struct alignas(64) Worker
+    {
+        SearchArena<HdaNode<State>> nodes;
+        StateTable<State> table;
+        BucketQueue open;
+        MessageQueue<Message> inbox;
+        vector<vector<Message>> outbox; // per owner
+        long long expanded = 0;
+        long long generated = 0;
+    };
+
+    int n;
+    const Heuristic &heuristic;
+    int thread_count;
+    State goal;
+    vector<unique_ptr<Worker>> workers; // kept across solves like a search workspace
+
+    atomic<long long> work;
+    atomic<int> best_cost;
+    mutex best_mutex;
+    uint32_t best_node;
+    int best_owner;
+
+    int owner_of(const State &state) const
+    {
+        return static_cast<int>(((state.hash() >> 32) * thread_count) >> 32);
+    }
+
+    void send(int to, vector<Message> &messages)
+    {
+        Batch *batch = new Batch;
+        batch->messages.swap(messages);
+        messages.reserve(BATCH_MESSAGES);
+        work.fetch_add(1);
+        workers[to]->inbox.push(batch);
+    }
+
+    void flush(Worker &worker)
+    {
+        for (int to = 0; to < thread_count; ++to)
+            if (!worker.outbox[to].empty())
+                send(to, worker.outbox[to]);
+    }
+
+    // Receiving a state at its owner
+    void add(Worker &worker, const Message &message)
+    {
+        int f = message.cost + message.heuristic;
+        if (f >= best_cost.load(memory_order_relaxed))
+            return;
+
+        uint32_t node = worker.table.find(message.state, worker.nodes);
+        if (node == NO_NODE)
+        {
+            node = worker.nodes.push_back({message.state, message.cost, message.heuristic, message.parent, message.parent_owner, false});
+            worker.table.insert(node, worker.nodes);
+        }
+        else if (worker.nodes[node].cost <= message.cost)
+            return;
+        else
+        {
+            // Cheaper path to a known state, reopened if it was closed
+            HdaNode<State> &known = worker.nodes[node];
+            known.cost = message.cost;
+            known.parent = message.parent;
+            known.parent_owner = message.parent_owner;
+            known.closed = false;
+        }
+        worker.open.push(node, f);
+        worker.generated++;
+    }
+
+    void expand(int id, uint32_t current)
+    {
+        Worker &worker = *workers[id];
+        HdaNode<State> node = worker.nodes[current];
+        worker.expanded++;
+
+        if (node.heuristic == 0 && node.state == goal)
+        {
+            lock_guard<mutex> lock(best_mutex);
+            if (node.cost < best_cost.load())
+            {
+                best_cost.store(node.cost);
+                best_node = current;
+                best_owner = id;
+            }
+            return;
+        }
+        worker.nodes[current].closed = true;
+
+        int blank_x = node.state.blank / n;
+        int blank_y = node.state.blank % n;
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = blank_x + row_move[i];
+            int newY = blank_y + col_move[i];
+            if (newX < 0 || newX >= n || newY < 0 || newY >= n)
+                continue;
+
+            Message child{node.state, node.cost + 1, 0, current, static_cast<uint16_t>(id)};
+            child.heuristic = heuristic.after_move(node.state, node.heuristic, node.state.tile(newX * n + newY), newX * n + newY, node.state.blank);
+            child.state.move_blank(newX * n + newY);
+
+            int owner = owner_of(child.state);
+            if (owner == id)
+                add(worker, child);
+            else
+            {
+                worker.outbox[owner].push_back(child);
+                if (worker.outbox[owner].size() >= BATCH_MESSAGES)
+                    send(owner, worker.outbox[owner]);
+            }
+        }
+    }
+
+    void run(int id)
+    {
+        Worker &worker = *workers[id];
+        bool busy = true; // counted in work
+        int since_flush = 0;
+        int idle_polls = 0;
+        while (true)
+        {
+            while (Batch *batch = worker.inbox.pop())
+            {
+                if (!busy)
+                {
+                    work.fetch_add(1);
+                    busy = true;
+                }
+                for (const Message &message : batch->messages)
+                    add(worker, message);
+                delete batch;
+                work.fetch_sub(1);
+            }
+
+            // Best open node below the solution found so far, outdated and pruned entries are dropped
+            uint32_t current = NO_NODE;
+            while (current == NO_NODE && !worker.open.empty())
+            {
+                int f;
+                uint32_t node = worker.open.pop(f);
+                const HdaNode<State> &entry = worker.nodes[node];
+                if (!entry.closed && f == entry.cost + entry.heuristic && f < best_cost.load(memory_order_relaxed))
+                    current = node;
+            }
+
+            if (current != NO_NODE)
+            {
+                idle_polls = 0;
+                expand(id, current);
+                if (++since_flush >= FLUSH_EXPANSIONS)
+                {
+                    flush(worker);
+                    since_flush = 0;
+                }
+                continue;
+            }
+
+            // Nothing left to expand: pass on what is buffered, then wait for batches or the end
+            flush(worker);
+            since_flush = 0;
+            if (busy)
+            {
+                busy = false;
+                work.fetch_sub(1);
+            }
+            if (work.load() == 0)
+                return;
+            // Backing off when idle for long, so waiting threads leave the cores to the working ones
+            if (++idle_polls < IDLE_POLLS)
+                this_thread::yield();
+            else
+                this_thread::sleep_for(chrono::microseconds(50));
+        }
+    }
+
+public:
+    HdaStar(int N, const Heuristic &Heuristic_, int threads)
+        : n(N), heuristic(Heuristic_), thread_count(max(1, min(threads, 1 << 16))), goal(goal_state_of<State>(N))
+    {
+        for (int t = 0; t < thread_count; ++t)
+        {
+            workers.emplace_back(new Worker);
+            workers.back()->outbox.resize(thread_count);
+        }
+    }
+
+    // Optimal number of moves, -1 if the goal is unreachable
+    int solve(const State &start)
+    {
+        for (auto &worker : workers)
+        {
+            worker->nodes.clear();
+            worker->table.clear();
+            worker->open.clear();
+            worker->expanded = worker->generated = 0;
+        }
+        best_cost.store(INT_MAX);
+        best_node = NO_NODE;
+        best_owner = 0;
+
+        Message first{start, 0, heuristic.evaluate(start), NO_NODE, 0};
+        add(*workers[owner_of(start)], first);
+        workers[owner_of(start)]->generated = 0;
+
+        work.store(thread_count);
+        vector<thread> threads;
+        for (int t = 0; t < thread_count; ++t)
+            threads.emplace_back(&HdaStar::run, this, t);
+        for (auto &t : threads)
+            t.join();
+
+        return best_node == NO_NODE ? -1 : best_cost.load();
+    }
+
+    // States from the start to the goal of the last solve
+    vector<State> get_path() const
+    {
+        vector<State> path;
+        int owner = best_owner;
+        for (uint32_t node = best_node; node != NO_NODE;)
+        {
+            const HdaNode<State> &entry = workers[owner]->nodes[node];
+            path.push_back(entry.state);
+            node = entry.parent;
+            owner = entry.parent_owner;
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    long long get_expanded() const
+    {
+        long long total = 0;
+        for (auto &worker : workers)
+            total += worker->expanded;
+        return total;
+    }
+
+    long long get_generated() const
+    {
+        long long total = 0;
+        for (auto &worker : workers)
+            total += worker->generated;
+        return total;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "puzzle_pdb.hpp"
+#include <cstdlib>
+#include <unordered_map>
+#include <mutex>
+
+// Board geometry shared by the depth-first searches: neighbour cells of every cell, in row_move/col_move order
+struct PuzzleGeometry
+{
+    int n;
+    int cells;
+    vector<array<int, 4>> neighbours;
+    vector<int> neighbour_count;
+
+    explicit PuzzleGeometry(int N) : n(N), cells(N * N), neighbours(N * N), neighbour_count(N * N, 0)
+    {
+        for (int cell = 0; cell < cells; ++cell)
+            for (int i = 0; i < 4; ++i)
+            {
+                int x = cell / n + row_move[i];
+                int y = cell % n + col_move[i];
+                if (x >= 0 && x < n && y >= 0 && y < n)
+                    neighbours[cell][neighbour_count[cell]++] = x * n + y;
+            }
+    }
+};
+
+// Hamming distance: number of misplaced tiles
+class HammingHeuristic
+{
+    int cells;
+
+public:
+    explicit HammingHeuristic(int n) : cells(n * n) {}
+
+    template <class State>
+    int evaluate(const State &state) const
+    {
+        int distance = 0;
+        for (int cell = 0; cell < cells; cell++)
+            if (state.tile(cell) != 0 && state.tile(cell) != cell + 1)
+                distance++;
+        return distance;
+    }
+
+    template <class State>
+    int after_move(const State &, int h, int tile, int from, int to) const
+    {
+        return h + (tile == from + 1) - (tile == to + 1);
+    }
+};
+
+// Manhattan distance with O(1) updates: a precomputed distance of every tile from every cell
+class ManhattanHeuristic
+{
+    int cells;
+    vector<uint8_t> distance; // [tile * cells + cell]
+
+public:
+    explicit ManhattanHeuristic(int n) : cells(n * n), distance(n * n * n * n, 0)
+    {
+        for (int tile = 1; tile < cells; ++tile)
+            for (int cell = 0; cell < cells; ++cell)
+                distance[tile * cells + cell] = abs(cell / n - (tile - 1) / n) + abs(cell % n - (tile - 1) % n);
+    }
+
+    template <class State>
+    int evaluate(const State &state) const
+    {
+        int h = 0;
+        for (int cell = 0; cell < cells; ++cell)
+            h += distance[state.tile(cell) * cells + cell];
+        return h;
+    }
+
+    // Heuristic of the state after the tile at from slides into the blank at to
+    // (state is the position before the move)
+    template <class State>
+    int after_move(const State &, int h, int tile, int from, int to) const
+    {
+        return h + distance[tile * cells + to] - distance[tile * cells + from];
+    }
+};
+
+// Linear conflict: Manhattan distance plus two moves for every tile that has to leave its goal line
+// so the others can pass. Per line that is the number of tiles in their goal line minus the longest
+// run of them already in goal order. A move only changes the two lines it crosses, only those are recounted.
+class LinearConflictHeuristic
+{
+    int n;
+    ManhattanHeuristic manhattan;
+
+    // Conflicts in row (or column) line
+    template <class State>
+    int line_conflicts(const State &state, int line, bool column) const
+    {
+        int positions[256];
+        int count = 0;
+        for (int k = 0; k < n; ++k)
+        {
+            int cell = column ? k * n + line : line * n + k;
+            int tile = state.tile(cell);
+            if (tile == 0)
+                continue;
+            int goal_row = (tile - 1) / n, goal_column = (tile - 1) % n;
+            if ((column ? goal_column : goal_row) == line)
+                positions[count++] = column ? goal_row : goal_column;
+        }
+
+        // Longest increasing run, lines are short enough for the quadratic version
+        int longest[256];
+        int best = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            longest[i] = 1;
+            for (int j = 0; j < i; ++j)
+                if (positions[j] < positions[i])
+                    longest[i] = max(longest[i], longest[j] + 1);
+            best = max(best, longest[i]);
+        }
+        return count - best;
+    }
+
+public:
+    explicit LinearConflictHeuristic(int N) : n(N), manhattan(N) {}
+
+    template <class State>
+    int evaluate(const State &state) const
+    {
+        int h = manhattan.evaluate(state);
+        for (int line = 0; line < n; ++line)
+            h += 2 * (line_conflicts(state, line, false) + line_conflicts(state, line, true));
+        return h;
+    }
+
+    template <class State>
+    int after_move(const State &state, int h, int tile, int from, int to) const
+    {
+        // A vertical move changes the order of two rows, a horizontal one of two columns
+        bool column = (from / n == to / n);
+        int first_line = column ? from % n : from / n;
+        int second_line = column ? to % n : to / n;
+
+        State moved = state;
+        moved.move_blank(from);
+        int before = line_conflicts(state, first_line, column) + line_conflicts(state, second_line, column);
+        int after = line_conflicts(moved, first_line, column) + line_conflicts(moved, second_line, column);
+        return manhattan.after_move(state, h, tile, from, to) - 2 * before + 2 * after;
+    }
+};
+
+// Walking distance (Takahashi): the vertical part abstracts a board to how many tiles of each goal row
+// sit in each row plus the blank's row, and counts the vertical moves needed to sort that out;
+// the horizontal part is the same on columns. The table of all abstract states is built once per size
+// by a breadth-first search from the goal, and serves both directions by symmetry.
+class WalkingDistanceHeuristic
+{
+    int n;
+    const unordered_map<uint64_t, uint8_t> *table;
+
+    // 3 bits per (line, goal line) count and the blank's line on top
+    static uint64_t encode(const vector<int> &counts, int blank_line, int n)
+    {
+        uint64_t key = 0;
+        for (int i = 0; i < n * n; ++i)
+            key |= static_cast<uint64_t>(counts[i]) << (3 * i);
+        return key | static_cast<uint64_t>(blank_line) << (3 * n * n);
+    }
+
+    static const unordered_map<uint64_t, uint8_t> &build_table(int n)
+    {
+        static unordered_map<int, unordered_map<uint64_t, uint8_t>> tables;
+        static mutex tables_mutex; // solver threads may ask for the same size at once
+        lock_guard<mutex> lock(tables_mutex);
+        auto found = tables.find(n);
+        if (found != tables.end())
+            return found->second;
+
+        unordered_map<uint64_t, uint8_t> &distances = tables[n];
+        vector<int> goal(n * n, 0);
+        for (int line = 0; line < n; ++line)
+            goal[line * n + line] = (line == n - 1) ? n - 1 : n;
+
+        vector<pair<vector<int>, int>> frontier(1, {goal, n - 1});
+        distances[encode(goal, n - 1, n)] = 0;
+        for (int distance = 1; !frontier.empty(); ++distance)
+        {
+            vector<pair<vector<int>, int>> next;
+            for (auto &[counts, blank_line] : frontier)
+                for (int step = -1; step <= 1; step += 2)
+                {
+                    int line = blank_line + step;
+                    if (line < 0 || line >= n)
+                        continue;
+                    // A tile of any goal line in the neighbouring line moves into the blank's line
+                    for (int goal_line = 0; goal_line < n; ++goal_line)
+                    {
+                        if (counts[line * n + goal_line] == 0)
+                            continue;
+                        vector<int> moved = counts;
+                        moved[line * n + goal_line]--;
+                        moved[blank_line * n + goal_line]++;
+                        if (distances.emplace(encode(moved, line, n), static_cast<uint8_t>(distance)).second)
+                            next.push_back({moved, line});
+                    }
+                }
+            frontier.swap(next);
+        }
+        return distances;
+    }
+
+    template <class State>
+    uint64_t key_of(const State &state, bool column) const
+    {
+        uint64_t key = 0;
+        for (int cell = 0; cell < n * n; ++cell)
+        {
+            int tile = state.tile(cell);
+            if (tile == 0)
+                continue;
+            int line = column ? cell % n : cell / n;
+            int goal_line = column ? (tile - 1) % n : (tile - 1) / n;
+            key += 1ULL << (3 * (line * n + goal_line));
+        }
+        int blank_line = column ? state.blank % n : state.blank / n;
+        return key | static_cast<uint64_t>(blank_line) << (3 * n * n);
+    }
+
+    int distance(uint64_t key) const { return table->at(key); }
+
+public:
+    // Boards up to 4x4, the abstract states of larger boards do not fit the key
+    static bool supports(int n) { return n <= 4; }
+
+    explicit WalkingDistanceHeuristic(int N) : n(N), table(&build_table(N)) {}
+
+    template <class State>
+    int evaluate(const State &state) const { return distance(key_of(state, false)) + distance(key_of(state, true)); }
+
+    template <class State>
+    int after_move(const State &state, int h, int tile, int from, int to) const
+    {
+        // Only the direction of the move changes its part of the distance: the tile changes line,
+        // the blank takes its old line
+        bool column = (from / n == to / n);
+        int from_line = column ? from % n : from / n;
+        int to_line = column ? to % n : to / n;
+        int goal_line = column ? (tile - 1) % n : (tile - 1) / n;
+
+        uint64_t key = key_of(state, column);
+        uint64_t moved = key - (1ULL << (3 * (from_line * n + goal_line))) + (1ULL << (3 * (to_line * n + goal_line)));
+        moved = (moved & ((1ULL << (3 * n * n)) - 1)) | static_cast<uint64_t>(from_line) << (3 * n * n);
+        return h - distance(key) + distance(moved);
+    }
+};
+
+// Additive pattern databases of the shared database, available once one is loaded for the board size
+class PatternDatabaseHeuristic
+{
+    const PatternDatabase *database;
+
+public:
+    static bool supports(int n) { return pattern_database().is_loaded() && pattern_database().get_n() == n; }
+
+    explicit PatternDatabaseHeuristic(int) : database(&pattern_database()) {}
+
+    template <class State>
+    int evaluate(const State &state) const { return database->evaluate(state); }
+
+    template <class State>
+    int after_move(const State &state, int h, int tile, int from, int to) const
+    {
+        return database->after_move(state, h, tile, from, to);
+    }
+};
+
+// Calling function with the heuristic object of method, false for an unknown method or an unsupported size
+template <class Function>
+bool with_heuristic(int n, char method, Function function)
+{
+    if (method == 'H')
+        function(HammingHeuristic(n));
+    else if (method == 'M')
+        function(ManhattanHeuristic(n));
+    else if (method == 'L')
+        function(LinearConflictHeuristic(n));
+    else if (method == 'W' && WalkingDistanceHeuristic::supports(n))
+        function(WalkingDistanceHeuristic(n));
+    else if (method == 'P' && PatternDatabaseHeuristic::supports(n))
+        function(PatternDatabaseHeuristic(n));
+    else
+        return false;
+    return true;
+}
\ No newline at end of file
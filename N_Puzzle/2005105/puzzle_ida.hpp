@@ -0,0 +1,79 @@
+#include "puzzle_heuristics.hpp"
+#include <climits>
+
+// IDA*: depth-first searches with a growing f bound, memory is the current path only
+// The board is changed in place along the path, the heuristic is updated per move and the blank never
+// moves straight back to the cell it came from.
+template <class State, class Heuristic>
+class IdaStar
+{
+    static const int FOUND = -1;
+
+    const PuzzleGeometry &geometry;
+    const Heuristic &heuristic;
+    State state;
+    State goal;
+    vector<int> path; // blank cells after each move
+    long long expanded = 0;
+    long long generated = 0;
+
+    int search(int g, int h, int bound, int previous_blank)
+    {
+        int f = g + h;
+        if (f > bound)
+            return f;
+        if (h == 0 && state == goal)
+            return FOUND;
+
+        expanded++;
+        int blank = state.blank;
+        int next_bound = INT_MAX;
+        for (int i = 0; i < geometry.neighbour_count[blank]; ++i)
+        {
+            int cell = geometry.neighbours[blank][i];
+            if (cell == previous_blank)
+                continue;
+
+            generated++;
+            int new_h = heuristic.after_move(state, h, state.tile(cell), cell, blank);
+            state.move_blank(cell);
+            path.push_back(cell);
+
+            int t = search(g + 1, new_h, bound, blank);
+            if (t == FOUND)
+                return FOUND;
+
+            path.pop_back();
+            state.move_blank(blank);
+            next_bound = min(next_bound, t);
+        }
+        return next_bound;
+    }
+
+public:
+    IdaStar(const PuzzleGeometry &Geometry, const Heuristic &Heuristic_) : geometry(Geometry), heuristic(Heuristic_) {}
+
+    // Optimal number of moves, the blank's cells along the solution are in get_path() afterwards
+    int solve(const State &start)
+    {
+        state = start;
+        goal = goal_state_of<State>(geometry.n);
+        path.clear();
+        expanded = generated = 0;
+
+        int h = heuristic.evaluate(state);
+        for (int bound = h;;)
+        {
+            int t = search(0, h, bound, -1);
+            if (t == FOUND)
+                return static_cast<int>(path.size());
+            if (t == INT_MAX)
+                return -1;
+            bound = t;
+        }
+    }
+
+    const vector<int> &get_path() const { return path; }
+    long long get_expanded() const { return expanded; }
+    long long get_generated() const { return generated; }
+};
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "puzzle_hda.hpp"
+
+// Bidirectional MM search (Holte et al.): one A*-like search forward from the start and one backward
+// from the goal, each ordered by priority max(f, 2g), so neither side expands a node past the middle of an
+// optimal path. Every generated state is looked up in the other side's table; the cheapest meeting is the
+// best solution so far. It is optimal once it is no longer than the largest of the lower bounds on any better
+// one: the lowest open priority, the lowest open f of each side and the two lowest open g plus one move.
+//
+// The backward side relabels tiles so the start becomes the goal: a tile is named after its cell in the
+// start plus one. Distances to the start are then distances to the ordinary goal, and every heuristic works
+// unchanged on that side. That needs the start's blank in the goal's corner. A blank in another corner is
+// brought there by mirroring the board, which keeps all distances. Otherwise the labels come from the start
+// with its blank walked to the nearest corner, and the heuristic is lowered by the walk's length
+// (the distance to the start differs from the distance to the walked board by at most that much).
+template <class State, class Heuristic>
+class MmSearch
+{
+    struct Side
+    {
+        SearchWorkspace<State> workspace; // open list by priority
+        BucketQueue by_f;                 // the open nodes again, by f and by g
+        BucketQueue by_g;
+        vector<int> to_other; // tile labels of the other side
+        vector<int> cell_to_other;
+        int slack = 0;        // subtracted from the heuristic
+        long long expanded = 0;
+        long long generated = 0;
+    };
+
+    int n;
+    const Heuristic &heuristic;
+    Side sides[2]; // forward, backward
+    int best;
+    uint32_t meet[2];
+
+    int heuristic_of(int k, int h) const { return max(0, h - sides[k].slack); }
+    int priority(int k, int g, int h) const { return max(g + heuristic_of(k, h), 2 * g); }
+
+    // State of side k as the other side stores it
+    State to_other_side(int k, const State &state) const
+    {
+        State converted;
+        for (int cell = 0; cell < n * n; ++cell)
+            converted.set_tile(sides[k].cell_to_other[cell], sides[k].to_other[state.tile(cell)]);
+        return converted;
+    }
+
+    // Adding or improving a state on side k, then looking for it on the other side
+    void reach(int k, const State &state, int g, int h, uint32_t parent)
+    {
+        SearchWorkspace<State> &workspace = sides[k].workspace;
+        uint32_t node = workspace.table.find(state, workspace.nodes);
+        if (node == NO_NODE)
+        {
+            node = workspace.nodes.push_back({state, g, h, parent, false});
+            workspace.table.insert(node, workspace.nodes);
+        }
+        else if (workspace.nodes[node].cost <= g)
+            return;
+        else
+        {
+            workspace.nodes[node].cost = g;
+            workspace.nodes[node].parent = parent;
+            workspace.nodes[node].closed = false;
+        }
+        workspace.open.push(node, priority(k, g, workspace.nodes[node].heuristic));
+        sides[k].by_f.push(node, g + heuristic_of(k, workspace.nodes[node].heuristic));
+        sides[k].by_g.push(node, g);
+        sides[k].generated++;
+
+        SearchWorkspace<State> &other = sides[1 - k].workspace;
+        uint32_t match = other.table.find(to_other_side(k, state), other.nodes);
+        if (match != NO_NODE && g + other.nodes[match].cost < best)
+        {
+            best = g + other.nodes[match].cost;
+            meet[k] = node;
+            meet[1 - k] = match;
+        }
+    }
+
+    // Lowest key of one of side k's open queues, dropping entries of closed nodes or with an outdated key,
+    // INT_MAX when it is empty
+    template <class Key>
+    int lowest(int k, BucketQueue &queue, Key key)
+    {
+        const SearchArena<SearchNode<State>> &nodes = sides[k].workspace.nodes;
+        while (!queue.empty())
+        {
+            int value;
+            uint32_t node = queue.top(value);
+            if (!nodes[node].closed && value == key(nodes[node]))
+                return value;
+            queue.pop(value);
+        }
+        return INT_MAX;
+    }
+
+    int lowest_priority(int k)
+    {
+        return lowest(k, sides[k].workspace.open, [&](const SearchNode<State> &node)
+                      { return priority(k, node.cost, node.heuristic); });
+    }
+
+    // Largest lower bound on a solution cheaper than the best one, from both open lists
+    int lower_bound(int forward, int backward)
+    {
+        int bound = min(forward, backward);
+        for (int k = 0; k < 2; ++k)
+            bound = max(bound, lowest(k, sides[k].by_f, [&](const SearchNode<State> &node)
+                                      { return node.cost + heuristic_of(k, node.heuristic); }));
+        int g_forward = lowest(0, sides[0].by_g, [](const SearchNode<State> &node)
+                               { return node.cost; });
+        int g_backward = lowest(1, sides[1].by_g, [](const SearchNode<State> &node)
+                                { return node.cost; });
+        if (g_forward != INT_MAX && g_backward != INT_MAX)
+            bound = max(bound, g_forward + g_backward + 1);
+        return bound;
+    }
+
+    void expand(int k)
+    {
+        SearchWorkspace<State> &workspace = sides[k].workspace;
+        int pr;
+        uint32_t current = workspace.open.pop(pr);
+        workspace.nodes[current].closed = true;
+        sides[k].expanded++;
+
+        const State state = workspace.nodes[current].state;
+        int g = workspace.nodes[current].cost;
+        int h = workspace.nodes[current].heuristic;
+        int blank_x = state.blank / n;
+        int blank_y = state.blank % n;
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = blank_x + row_move[i];
+            int newY = blank_y + col_move[i];
+            if (newX < 0 || newX >= n || newY < 0 || newY >= n)
+                continue;
+
+            State child = state;
+            int child_h = heuristic.after_move(child, h, child.tile(newX * n + newY), newX * n + newY, child.blank);
+            child.move_blank(newX * n + newY);
+            reach(k, child, g + 1, child_h, current);
+        }
+    }
+
+public:
+    MmSearch(int N, const Heuristic &Heuristic_) : n(N), heuristic(Heuristic_) {}
+
+    // Optimal number of moves, -1 if the goal is unreachable
+    int solve(const State &start)
+    {
+        // The start with its blank walked to the nearest corner, first along its column, then its row
+        int corner_row = (start.blank / n < n / 2) ? 0 : n - 1;
+        int corner_column = (start.blank % n < n / 2) ? 0 : n - 1;
+        State cornered = start;
+        int walk = 0;
+        for (int step = (corner_row > cornered.blank / n) ? n : -n; cornered.blank / n != corner_row; walk++)
+            cornered.move_blank(cornered.blank + step);
+        for (int step = (corner_column > cornered.blank % n) ? 1 : -1; cornered.blank % n != corner_column; walk++)
+            cornered.move_blank(cornered.blank + step);
+
+        // Mirroring that corner onto the goal's (its own inverse), then naming tiles after their mirrored cell
+        vector<int> mirror(n * n);
+        for (int cell = 0; cell < n * n; ++cell)
+        {
+            int row = (corner_row == n - 1) ? cell / n : n - 1 - cell / n;
+            int column = (corner_column == n - 1) ? cell % n : n - 1 - cell % n;
+            mirror[cell] = row * n + column;
+        }
+        vector<int> backward_label(n * n, 0), forward_label(n * n, 0);
+        for (int cell = 0; cell < n * n; ++cell)
+            if (cornered.tile(cell) != 0)
+            {
+                backward_label[cornered.tile(cell)] = mirror[cell] + 1;
+                forward_label[mirror[cell] + 1] = cornered.tile(cell);
+            }
+        sides[0].to_other = backward_label;
+        sides[1].to_other = forward_label;
+        sides[0].cell_to_other = sides[1].cell_to_other = mirror;
+        sides[0].slack = 0;
+        sides[1].slack = walk;
+
+        for (Side &side : sides)
+        {
+            side.workspace.clear();
+            side.by_f.clear();
+            side.by_g.clear();
+            side.expanded = side.generated = 0;
+        }
+        best = INT_MAX;
+        meet[0] = meet[1] = NO_NODE;
+
+        State backward_start = to_other_side(0, goal_state_of<State>(n));
+        reach(0, start, 0, heuristic.evaluate(start), NO_NODE);
+        reach(1, backward_start, 0, heuristic.evaluate(backward_start), NO_NODE);
+        sides[0].generated = sides[1].generated = 0;
+
+        while (true)
+        {
+            int forward = lowest_priority(0);
+            int backward = lowest_priority(1);
+            if (min(forward, backward) == INT_MAX || best <= lower_bound(forward, backward))
+                break;
+            expand(forward <= backward ? 0 : 1);
+        }
+        return best == INT_MAX ? -1 : best;
+    }
+
+    // States from the start to the goal of the last solve: the forward half up to the meeting state,
+    // then the backward half turned back into forward labels
+    vector<State> get_path() const
+    {
+        vector<State> path;
+        if (best == INT_MAX)
+            return path;
+
+        for (uint32_t node = meet[0]; node != NO_NODE; node = sides[0].workspace.nodes[node].parent)
+            path.push_back(sides[0].workspace.nodes[node].state);
+        reverse(path.begin(), path.end());
+
+        const SearchArena<SearchNode<State>> &backward = sides[1].workspace.nodes;
+        for (uint32_t node = backward[meet[1]].parent; node != NO_NODE; node = backward[node].parent)
+            path.push_back(to_other_side(1, backward[node].state));
+        return path;
+    }
+
+    long long get_expanded() const { return sides[0].expanded + sides[1].expanded; }
+    long long get_generated() const { return sides[0].generated + sides[1].generated; }
+
+    // Nodes stored by both sides
+    size_t get_stored() const { return sides[0].workspace.nodes.size() + sides[1].workspace.nodes.size(); }
+};
\ No newline at end of file
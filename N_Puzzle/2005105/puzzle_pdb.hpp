@@ -0,0 +1,393 @@
+#include "puzzle_search.hpp"
+#include "puzzle_mmap.hpp"
+#include <atomic>
+#include <thread>
+#include <string>
+#include <fstream>
+
+// Disjoint additive pattern databases
+//
+// The tiles are split into groups. For every placement of a group's tiles (the other tiles unlabeled),
+// the database holds the fewest moves of that group's tiles needed to solve it; moves of other tiles are
+// free, so the values of all groups add up to an admissible heuristic.
+// A placement is indexed by the rank of its cell sequence among all k-permutations of the cells.
+// Each value is stored in 4 bits as (value - Manhattan distance of the group) / 2, which is always even.
+
+const char PDB_MAGIC[4] = {'N', 'P', 'D', 'B'};
+const uint32_t PDB_VERSION = 1;
+const int PDB_MAX_GROUP_TILES = 28;
+
+struct PdbHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t n;
+    uint32_t group_count;
+};
+
+struct PdbGroupHeader
+{
+    uint32_t tile_count;
+    uint8_t tiles[PDB_MAX_GROUP_TILES];
+};
+
+inline string pattern_database_file(int n)
+{
+    return "npuzzle_pdb_" + to_string(n) + ".bin";
+}
+
+// Tile groups built for each size: 6-6-3 for the 15-puzzle, 5-5-5-5-4 for the 24-puzzle
+inline vector<vector<int>> default_pattern_groups(int n)
+{
+    if (n == 4)
+        return {{1, 5, 6, 9, 10, 13}, {7, 8, 11, 12, 14, 15}, {2, 3, 4}};
+    if (n == 5)
+        return {{1, 2, 3, 6, 7}, {4, 5, 8, 9, 10}, {11, 12, 16, 17, 21}, {13, 14, 15, 18, 19}, {20, 22, 23, 24}};
+    return {};
+}
+
+// Number of k-permutations of cells
+inline uint64_t placements(int cells, int k)
+{
+    uint64_t count = 1;
+    for (int i = 0; i < k; ++i)
+        count *= cells - i;
+    return count;
+}
+
+// Rank of the cell sequence among all k-permutations of cells: digit i is the cell's position
+// among the cells not used by the earlier tiles
+inline uint64_t rank_placement(const int *positions, int k, int cells)
+{
+    uint64_t rank = 0;
+    uint32_t used = 0;
+    for (int i = 0; i < k; ++i)
+    {
+        int digit = positions[i] - __builtin_popcount(used & ((1u << positions[i]) - 1));
+        rank = rank * (cells - i) + digit;
+        used |= 1u << positions[i];
+    }
+    return rank;
+}
+
+inline void unrank_placement(uint64_t rank, int k, int cells, int *positions)
+{
+    int digits[PDB_MAX_GROUP_TILES];
+    for (int i = k - 1; i >= 0; --i)
+    {
+        digits[i] = static_cast<int>(rank % (cells - i));
+        rank /= cells - i;
+    }
+    uint32_t used = 0;
+    for (int i = 0; i < k; ++i)
+    {
+        int cell = -1;
+        for (int skip = digits[i]; skip >= 0; --skip)
+            do
+                cell++;
+            while (used & (1u << cell));
+        positions[i] = cell;
+        used |= 1u << cell;
+    }
+}
+
+class PatternDatabase
+{
+    struct Group
+    {
+        vector<int> tiles;
+        const uint8_t *nibbles;
+    };
+
+    MappedFile file;
+    int n = 0;
+    vector<Group> groups;
+    vector<int> group_of_tile; // -1 for the blank
+    vector<uint8_t> manhattan; // [tile * cells + cell]
+
+    int group_delta(const Group &group, const int *positions) const
+    {
+        uint64_t rank = rank_placement(positions, group.tiles.size(), n * n);
+        return (group.nibbles[rank >> 1] >> ((rank & 1) * 4)) & 0xF;
+    }
+
+    // Positions of a group's tiles in the state
+    template <class State>
+    void group_positions(const State &state, const Group &group, int *positions) const
+    {
+        int cell_of_tile[256];
+        for (int cell = 0; cell < n * n; ++cell)
+            cell_of_tile[state.tile(cell)] = cell;
+        for (size_t i = 0; i < group.tiles.size(); ++i)
+            positions[i] = cell_of_tile[group.tiles[i]];
+    }
+
+    // Breadth-first search over (placement, blank cell) of one group, moves of the blank between free cells
+    // cost nothing, so each layer is first closed under them and then expanded by the group's tile moves.
+    // Threads split the layer bitmap by words and claim states with atomic bit sets.
+    static vector<uint8_t> build_group(int n, const vector<int> &tiles, ostream &progress)
+    {
+        int cells = n * n, k = tiles.size();
+        uint64_t ranks = placements(cells, k);
+        uint64_t states = ranks * cells;
+        size_t words = (states + 63) / 64;
+        vector<atomic<uint64_t>> visited(words), current(words), next(words);
+        vector<atomic<uint8_t>> cost(ranks);
+        for (auto &c : cost)
+            c.store(255, memory_order_relaxed);
+
+        vector<vector<int>> neighbours(cells);
+        for (int cell = 0; cell < cells; ++cell)
+            for (int i = 0; i < 4; ++i)
+            {
+                int x = cell / n + row_move[i], y = cell % n + col_move[i];
+                if (x >= 0 && x < n && y >= 0 && y < n)
+                    neighbours[cell].push_back(x * n + y);
+            }
+
+        auto claim = [&](vector<atomic<uint64_t>> &bits, uint64_t state)
+        {
+            uint64_t bit = 1ULL << (state & 63);
+            return (bits[state >> 6].fetch_or(bit, memory_order_relaxed) & bit) == 0;
+        };
+
+        int goal_positions[PDB_MAX_GROUP_TILES];
+        for (int i = 0; i < k; ++i)
+            goal_positions[i] = tiles[i] - 1;
+        uint64_t goal = rank_placement(goal_positions, k, cells) * cells + (cells - 1);
+        claim(visited, goal);
+        claim(current, goal);
+        cost[goal / cells].store(0, memory_order_relaxed);
+
+        unsigned threads = max(1u, thread::hardware_concurrency());
+        auto parallel_words = [&](auto body)
+        {
+            atomic<size_t> next_block(0);
+            const size_t BLOCK = 4096;
+            vector<thread> workers;
+            for (unsigned t = 0; t < threads; ++t)
+                workers.emplace_back([&]
+                                     {
+                                         for (size_t begin = next_block.fetch_add(BLOCK); begin < words; begin = next_block.fetch_add(BLOCK))
+                                             for (size_t word = begin; word < min(words, begin + BLOCK); ++word)
+                                                 for (uint64_t bits = current[word].load(memory_order_relaxed); bits; bits &= bits - 1)
+                                                     body(word * 64 + __builtin_ctzll(bits)); });
+            for (auto &w : workers)
+                w.join();
+        };
+
+        for (int layer = 0;; ++layer)
+        {
+            // Phase 1: free blank moves, flood filling the blank's region for the placement
+            parallel_words([&](uint64_t state)
+                           {
+                               uint64_t rank = state / cells;
+                               int positions[PDB_MAX_GROUP_TILES];
+                               unrank_placement(rank, k, cells, positions);
+                               uint32_t occupied = 0;
+                               for (int i = 0; i < k; ++i)
+                                   occupied |= 1u << positions[i];
+
+                               vector<int> stack(1, static_cast<int>(state % cells));
+                               while (!stack.empty())
+                               {
+                                   int blank = stack.back();
+                                   stack.pop_back();
+                                   for (int cell : neighbours[blank])
+                                       if (!(occupied & (1u << cell)) && claim(visited, rank * cells + cell))
+                                       {
+                                           claim(current, rank * cells + cell);
+                                           stack.push_back(cell);
+                                       }
+                               } });
+
+            // Phase 2: moves of the group's tiles into the blank, one step further
+            atomic<bool> any(false);
+            parallel_words([&](uint64_t state)
+                           {
+                               uint64_t rank = state / cells;
+                               int blank = state % cells;
+                               int positions[PDB_MAX_GROUP_TILES];
+                               unrank_placement(rank, k, cells, positions);
+                               for (int i = 0; i < k; ++i)
+                               {
+                                   int cell = positions[i];
+                                   if (find(neighbours[blank].begin(), neighbours[blank].end(), cell) == neighbours[blank].end())
+                                       continue;
+                                   positions[i] = blank;
+                                   uint64_t moved_rank = rank_placement(positions, k, cells);
+                                   positions[i] = cell;
+                                   if (claim(visited, moved_rank * cells + cell))
+                                   {
+                                       claim(next, moved_rank * cells + cell);
+                                       uint8_t unknown = 255;
+                                       cost[moved_rank].compare_exchange_strong(unknown, static_cast<uint8_t>(layer + 1), memory_order_relaxed);
+                                       any.store(true, memory_order_relaxed);
+                                   }
+                               } });
+
+            progress << "Pattern database layer " << layer << " done" << endl;
+            if (!any.load())
+                break;
+            current.swap(next);
+            for (auto &word : next)
+                word.store(0, memory_order_relaxed);
+        }
+
+        // Values relative to the group's Manhattan distance, halved, in 4 bits
+        vector<uint8_t> nibbles((ranks + 1) / 2, 0);
+        for (uint64_t rank = 0; rank < ranks; ++rank)
+        {
+            int positions[PDB_MAX_GROUP_TILES];
+            unrank_placement(rank, k, cells, positions);
+            int distance = 0;
+            for (int i = 0; i < k; ++i)
+                distance += abs(positions[i] / n - (tiles[i] - 1) / n) + abs(positions[i] % n - (tiles[i] - 1) % n);
+            int value = cost[rank].load(memory_order_relaxed);
+            int delta = (value == 255) ? 0 : min(15, (value - distance) / 2);
+            nibbles[rank >> 1] |= delta << ((rank & 1) * 4);
+        }
+        return nibbles;
+    }
+
+public:
+    bool load(const string &path)
+    {
+        groups.clear();
+        n = 0;
+        if (!file.open(path))
+            return false;
+
+        PdbHeader header;
+        if (file.size() < sizeof(header))
+        {
+            file.close();
+            return false;
+        }
+        memcpy(&header, file.data(), sizeof(header));
+        if (memcmp(header.magic, PDB_MAGIC, 4) != 0 || header.version != PDB_VERSION || header.n < 2 || header.n > 5)
+        {
+            file.close();
+            return false;
+        }
+
+        int cells = header.n * header.n;
+        size_t offset = sizeof(header) + header.group_count * sizeof(PdbGroupHeader);
+        vector<int> owner(cells, -1);
+        for (uint32_t g = 0; g < header.group_count && offset <= file.size(); ++g)
+        {
+            PdbGroupHeader group_header;
+            memcpy(&group_header, file.data() + sizeof(header) + g * sizeof(PdbGroupHeader), sizeof(group_header));
+            if (group_header.tile_count == 0 || group_header.tile_count > PDB_MAX_GROUP_TILES)
+                break;
+
+            Group group;
+            group.tiles.assign(group_header.tiles, group_header.tiles + group_header.tile_count);
+            group.nibbles = file.data() + offset;
+            for (int tile : group.tiles)
+                if (tile > 0 && tile < cells)
+                    owner[tile] = g;
+            offset += (placements(cells, group.tiles.size()) + 1) / 2;
+            groups.push_back(group);
+        }
+
+        // Every tile in exactly one group and the file exactly as long as the tables
+        bool complete = groups.size() == header.group_count && offset == file.size() &&
+                        count(owner.begin() + 1, owner.end(), -1) == 0;
+        if (!complete)
+        {
+            groups.clear();
+            file.close();
+            return false;
+        }
+
+        n = header.n;
+        group_of_tile = owner;
+        manhattan.assign(cells * cells, 0);
+        for (int tile = 1; tile < cells; ++tile)
+            for (int cell = 0; cell < cells; ++cell)
+                manhattan[tile * cells + cell] = abs(cell / n - (tile - 1) / n) + abs(cell % n - (tile - 1) % n);
+        return true;
+    }
+
+    bool is_loaded() const { return n > 0; }
+    int get_n() const { return n; }
+
+    template <class State>
+    int evaluate(const State &state) const
+    {
+        int cells = n * n;
+        int cell_of_tile[256];
+        int h = 0;
+        for (int cell = 0; cell < cells; ++cell)
+        {
+            cell_of_tile[state.tile(cell)] = cell;
+            h += manhattan[state.tile(cell) * cells + cell];
+        }
+
+        int positions[PDB_MAX_GROUP_TILES];
+        for (const Group &group : groups)
+        {
+            for (size_t i = 0; i < group.tiles.size(); ++i)
+                positions[i] = cell_of_tile[group.tiles[i]];
+            h += 2 * group_delta(group, positions);
+        }
+        return h;
+    }
+
+    // Only the moved tile's group changes its table value
+    template <class State>
+    int after_move(const State &state, int h, int tile, int from, int to) const
+    {
+        int cells = n * n;
+        const Group &group = groups[group_of_tile[tile]];
+        int positions[PDB_MAX_GROUP_TILES];
+        group_positions(state, group, positions);
+        int before = group_delta(group, positions);
+        for (size_t i = 0; i < group.tiles.size(); ++i)
+            if (positions[i] == from)
+                positions[i] = to;
+        int after = group_delta(group, positions);
+        return h + manhattan[tile * cells + to] - manhattan[tile * cells + from] + 2 * (after - before);
+    }
+
+    // Building the databases of all groups and writing them to path
+    static bool build(int n, const vector<vector<int>> &tile_groups, const string &path, ostream &progress)
+    {
+        if (tile_groups.empty() || n * n > 32)
+            return false;
+
+        ofstream output(path, ios::binary);
+        if (!output)
+            return false;
+
+        PdbHeader header;
+        memcpy(header.magic, PDB_MAGIC, 4);
+        header.version = PDB_VERSION;
+        header.n = n;
+        header.group_count = tile_groups.size();
+        output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const vector<int> &tiles : tile_groups)
+        {
+            PdbGroupHeader group_header = {};
+            group_header.tile_count = tiles.size();
+            copy(tiles.begin(), tiles.end(), group_header.tiles);
+            output.write(reinterpret_cast<const char *>(&group_header), sizeof(group_header));
+        }
+
+        for (const vector<int> &tiles : tile_groups)
+        {
+            progress << "Building pattern database of " << tiles.size() << " tiles" << endl;
+            vector<uint8_t> nibbles = build_group(n, tiles, progress);
+            output.write(reinterpret_cast<const char *>(nibbles.data()), nibbles.size());
+        }
+        return static_cast<bool>(output);
+    }
+};
+
+// Shared read-only database, loaded once at startup
+inline PatternDatabase &pattern_database()
+{
+    static PatternDatabase database;
+    return database;
+}
\ No newline at end of file
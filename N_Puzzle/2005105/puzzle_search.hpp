@@ -0,0 +1,188 @@
+#include "puzzle_state.hpp"
+
+// Search graph of the A*: one node per distinct state, found through an open-addressing table,
+// and an open list of node indices bucketed by f
+
+const uint32_t NO_NODE = UINT32_MAX;
+
+template <class State>
+struct SearchNode
+{
+    State state;
+    int cost;        // g, best known distance from the start
+    int heuristic;   // h
+    uint32_t parent; // node index, NO_NODE for the start
+    bool closed;
+};
+
+// Append-only node storage in fixed-size chunks, nodes are addressed by 32-bit index and never move
+// clear() keeps the chunks for the next solve, the destructor frees all of them at once
+template <class Node>
+class SearchArena
+{
+    static const int CHUNK_BITS = 16;
+    static const uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+
+    vector<vector<Node>> chunks;
+    uint32_t count = 0;
+
+public:
+    uint32_t size() const { return count; }
+
+    Node &operator[](uint32_t index) { return chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)]; }
+    const Node &operator[](uint32_t index) const { return chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)]; }
+
+    uint32_t push_back(const Node &node)
+    {
+        uint32_t chunk = count >> CHUNK_BITS;
+        if (chunk == chunks.size())
+        {
+            chunks.emplace_back();
+            chunks.back().reserve(CHUNK_SIZE);
+        }
+        chunks[chunk].push_back(node);
+        return count++;
+    }
+
+    void clear()
+    {
+        for (auto &chunk : chunks)
+            chunk.clear();
+        count = 0;
+    }
+
+    // Memory held by the nodes, used or kept for reuse
+    size_t capacity_bytes() const { return chunks.size() * CHUNK_SIZE * sizeof(Node); }
+};
+
+// State -> node index, linear probing over a power of two table kept at most half full
+// Each slot keeps the upper hash bits, so most mismatches never touch the node
+template <class State>
+class StateTable
+{
+    struct Slot
+    {
+        uint32_t node;
+        uint32_t tag;
+    };
+
+    vector<Slot> slots;
+    size_t count = 0;
+    size_t mask = 0;
+
+    template <class Nodes>
+    void grow(const Nodes &nodes)
+    {
+        vector<Slot> old_slots(max<size_t>(slots.size() * 2, 1024), Slot{NO_NODE, 0});
+        old_slots.swap(slots);
+        mask = slots.size() - 1;
+        for (const Slot &slot : old_slots)
+        {
+            if (slot.node == NO_NODE)
+                continue;
+            size_t index = nodes[slot.node].state.hash() & mask;
+            while (slots[index].node != NO_NODE)
+                index = (index + 1) & mask;
+            slots[index] = slot;
+        }
+    }
+
+public:
+    void clear()
+    {
+        fill(slots.begin(), slots.end(), Slot{NO_NODE, 0});
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+
+    template <class Nodes>
+    uint32_t find(const State &state, const Nodes &nodes) const
+    {
+        if (slots.empty())
+            return NO_NODE;
+        uint64_t hash = state.hash();
+        uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        for (size_t index = hash & mask; slots[index].node != NO_NODE; index = (index + 1) & mask)
+            if (slots[index].tag == tag && nodes[slots[index].node].state == state)
+                return slots[index].node;
+        return NO_NODE;
+    }
+
+    // Adding a node whose state is not in the table yet
+    template <class Nodes>
+    void insert(uint32_t node, const Nodes &nodes)
+    {
+        if (2 * (count + 1) > slots.size())
+            grow(nodes);
+        uint64_t hash = nodes[node].state.hash();
+        size_t index = hash & mask;
+        while (slots[index].node != NO_NODE)
+            index = (index + 1) & mask;
+        slots[index] = Slot{node, static_cast<uint32_t>(hash >> 32)};
+        count++;
+    }
+};
+
+// Open list with one LIFO bucket per f value, f values of the puzzle are small integers
+// A node is pushed again when its cost improves, the outdated entry is skipped by the caller
+class BucketQueue
+{
+    vector<vector<uint32_t>> buckets;
+    size_t lowest = 0;
+    size_t count = 0;
+
+public:
+    void clear()
+    {
+        for (auto &bucket : buckets)
+            bucket.clear();
+        lowest = 0;
+        count = 0;
+    }
+
+    bool empty() const { return count == 0; }
+
+    void push(uint32_t node, int f)
+    {
+        if (static_cast<size_t>(f) >= buckets.size())
+            buckets.resize(f + 1);
+        buckets[f].push_back(node);
+        lowest = min(lowest, static_cast<size_t>(f));
+        count++;
+    }
+
+    // Node with the lowest f, the most recently pushed one among equal f
+    uint32_t pop(int &f)
+    {
+        uint32_t node = top(f);
+        buckets[lowest].pop_back();
+        count--;
+        return node;
+    }
+
+    // Node pop() would return, left in the queue
+    uint32_t top(int &f)
+    {
+        while (buckets[lowest].empty())
+            lowest++;
+        f = static_cast<int>(lowest);
+        return buckets[lowest].back();
+    }
+};
+
+// Everything one search needs, reused across solves so a batch of solves does not grow the process
+template <class State>
+struct SearchWorkspace
+{
+    SearchArena<SearchNode<State>> nodes;
+    StateTable<State> table;
+    BucketQueue open;
+
+    void clear()
+    {
+        nodes.clear();
+        table.clear();
+        open.clear();
+    }
+};
\ No newline at end of file
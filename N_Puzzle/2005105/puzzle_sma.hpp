@@ -0,0 +1,250 @@
+#include "puzzle_mm.hpp"
+#include <set>
+#include <tuple>
+
+// SMA* (simplified memory-bounded A*): the search tree never holds more than a fixed number of nodes.
+// Successors are generated one at a time. When the budget is used up, the worst leaf (highest f, then
+// shallowest) is dropped and its parent remembers its f for that move; the move is generated again with at
+// least that f if the parent becomes the best node again. A node's f is backed up to the lowest f of its
+// children in memory and of its missing successors. Every f stays a lower bound, so the first goal selected
+// is optimal unless the budget is too small for the solution path.
+
+const size_t SMA_DEFAULT_BUDGET = 1 << 20;
+
+template <class State>
+struct SmaNode
+{
+    State state;
+    int cost;
+    int heuristic;
+    int f;                      // backed-up lower bound of every solution below the node
+    int key;                    // queue key, the best f a missing successor can have
+    uint32_t parent;
+    uint32_t children[4];       // per move, NO_NODE when not in memory
+    int forgotten[4];           // f of a dropped successor per move, 0 if none was dropped
+    uint8_t moves;              // moves to generate, the move back to the parent excluded
+    uint8_t in_memory;          // moves whose successor is in memory
+    uint8_t move_from_parent;
+    bool queued;
+};
+
+template <class State, class Heuristic>
+class SmaStar
+{
+    typedef tuple<int, int, uint32_t> QueueEntry; // key, -cost (deeper first), node
+
+    int n;
+    const Heuristic &heuristic;
+    size_t budget;
+    State goal;
+    vector<SmaNode<State>> nodes; // reserved to the budget up front
+    vector<uint32_t> free_nodes;
+    set<QueueEntry> queue;
+    set<QueueEntry> leaves; // the queued nodes without children in memory, the root excluded
+    uint32_t goal_node;
+    long long expanded = 0;
+    long long generated = 0;
+    long long dropped = 0;
+
+    bool complete(const SmaNode<State> &node) const { return node.in_memory == node.moves; }
+
+    // Best f a missing successor of node can have
+    int next_key(const SmaNode<State> &node) const
+    {
+        int key = INT_MAX;
+        for (int i = 0; i < 4; ++i)
+            if ((node.moves & ~node.in_memory) & (1 << i))
+                key = min(key, max(node.f, node.forgotten[i]));
+        return key;
+    }
+
+    void dequeue(uint32_t index)
+    {
+        SmaNode<State> &node = nodes[index];
+        if (node.queued)
+        {
+            queue.erase(QueueEntry{node.key, -node.cost, index});
+            leaves.erase(QueueEntry{node.key, -node.cost, index});
+        }
+        node.queued = false;
+    }
+
+    // Queued again with its current key, or left out when all its successors are in memory
+    void requeue(uint32_t index)
+    {
+        dequeue(index);
+        SmaNode<State> &node = nodes[index];
+        if (complete(node))
+            return;
+        node.key = next_key(node);
+        node.queued = true;
+        queue.insert(QueueEntry{node.key, -node.cost, index});
+        if (node.in_memory == 0 && node.parent != NO_NODE)
+            leaves.insert(QueueEntry{node.key, -node.cost, index});
+    }
+
+    // A node's f is the lowest of its children's f and of what its missing successors can have, passed up
+    // to the ancestors while it rises
+    void back_up(uint32_t index)
+    {
+        while (index != NO_NODE)
+        {
+            SmaNode<State> &node = nodes[index];
+            int lowest = next_key(node);
+            for (int i = 0; i < 4; ++i)
+                if (node.in_memory & (1 << i))
+                    lowest = min(lowest, nodes[node.children[i]].f);
+            if (lowest <= node.f)
+                return;
+            node.f = lowest;
+            requeue(index);
+            index = node.parent;
+        }
+    }
+
+    // Dropping the worst queued leaf other than keep, false if there is none
+    bool drop_worst_leaf(uint32_t keep)
+    {
+        for (auto entry = leaves.rbegin(); entry != leaves.rend(); ++entry)
+        {
+            uint32_t index = get<2>(*entry);
+            SmaNode<State> &node = nodes[index];
+            if (index == keep)
+                continue;
+
+            dequeue(index);
+            SmaNode<State> &parent = nodes[node.parent];
+            int move = node.move_from_parent;
+            parent.children[move] = NO_NODE;
+            parent.in_memory &= ~(1 << move);
+            parent.forgotten[move] = node.f;
+            requeue(node.parent);
+            back_up(node.parent);
+
+            free_nodes.push_back(index);
+            dropped++;
+            return true;
+        }
+        return false;
+    }
+
+    uint32_t allocate(const SmaNode<State> &node)
+    {
+        if (!free_nodes.empty())
+        {
+            uint32_t index = free_nodes.back();
+            free_nodes.pop_back();
+            nodes[index] = node;
+            return index;
+        }
+        nodes.push_back(node);
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    SmaNode<State> make_node(const State &state, int cost, int h, int f, uint32_t parent, int move_from_parent) const
+    {
+        SmaNode<State> node;
+        node.state = state;
+        node.cost = cost;
+        node.heuristic = h;
+        node.f = f;
+        node.key = f;
+        node.parent = parent;
+        node.move_from_parent = static_cast<uint8_t>(move_from_parent);
+        node.in_memory = 0;
+        node.queued = false;
+        node.moves = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            node.children[i] = NO_NODE;
+            node.forgotten[i] = 0;
+            int x = state.blank / n + row_move[i], y = state.blank % n + col_move[i];
+            bool back = (parent != NO_NODE && (i ^ 1) == move_from_parent); // moves come in opposite pairs
+            if (x >= 0 && x < n && y >= 0 && y < n && !back)
+                node.moves |= 1 << i;
+        }
+        return node;
+    }
+
+public:
+    SmaStar(int N, const Heuristic &Heuristic_, size_t node_budget)
+        : n(N), heuristic(Heuristic_), budget(max<size_t>(node_budget, 2)), goal(goal_state_of<State>(N))
+    {
+        nodes.reserve(budget);
+        free_nodes.reserve(budget);
+    }
+
+    // Optimal number of moves, -1 if no solution fits the budget
+    int solve(const State &start)
+    {
+        nodes.clear();
+        free_nodes.clear();
+        queue.clear();
+        leaves.clear();
+        goal_node = NO_NODE;
+        expanded = generated = dropped = 0;
+
+        int h = heuristic.evaluate(start);
+        requeue(allocate(make_node(start, 0, h, h, NO_NODE, 0)));
+
+        while (!queue.empty())
+        {
+            uint32_t current = get<2>(*queue.begin());
+            if (nodes[current].key == INT_MAX)
+                return -1;
+            if (nodes[current].heuristic == 0 && nodes[current].state == goal)
+            {
+                goal_node = current;
+                return nodes[current].cost;
+            }
+            expanded++;
+
+            // Missing successor with the best known f
+            int move = -1;
+            for (int i = 0; i < 4; ++i)
+                if (((nodes[current].moves & ~nodes[current].in_memory) & (1 << i)) &&
+                    (move < 0 || nodes[current].forgotten[i] < nodes[current].forgotten[move]))
+                    move = i;
+
+            if (nodes.size() - free_nodes.size() >= budget && !drop_worst_leaf(current))
+                return -1;
+
+            const SmaNode<State> &parent = nodes[current];
+            int cell = (parent.state.blank / n + row_move[move]) * n + parent.state.blank % n + col_move[move];
+            State state = parent.state;
+            int child_h = heuristic.after_move(state, parent.heuristic, state.tile(cell), cell, state.blank);
+            state.move_blank(cell);
+            int cost = parent.cost + 1;
+
+            // No room below a node as deep as the budget, unless it is the goal
+            int f = max(max(parent.f, cost + child_h), parent.forgotten[move]);
+            if (static_cast<size_t>(cost) + 1 >= budget && !(child_h == 0 && state == goal))
+                f = INT_MAX;
+
+            uint32_t child = allocate(make_node(state, cost, child_h, f, current, move));
+            generated++;
+            nodes[current].children[move] = child;
+            nodes[current].in_memory |= 1 << move;
+            nodes[current].forgotten[move] = 0;
+
+            requeue(current);
+            requeue(child);
+            back_up(current);
+        }
+        return -1;
+    }
+
+    // States from the start to the goal of the last solve
+    vector<State> get_path() const
+    {
+        vector<State> path;
+        for (uint32_t node = goal_node; node != NO_NODE; node = nodes[node].parent)
+            path.push_back(nodes[node].state);
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    long long get_expanded() const { return expanded; }
+    long long get_generated() const { return generated; }
+    long long get_dropped() const { return dropped; }
+};
\ No newline at end of file
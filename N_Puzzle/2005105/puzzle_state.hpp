@@ -0,0 +1,233 @@
+#include <iostream>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+// Compact puzzle states
+// A state stores the tile of every cell (row major, 0 is the blank) and the blank's cell.
+// Moving the blank and hashing are O(1) for every state type.
+
+// Possible moves in the puzzle for the blank tile
+// Left, Right, Down, Up
+int row_move[] = {-1, 1, 0, 0};
+int col_move[] = {0, 0, -1, 1};
+
+// Boards up to 4x4: 4 bits per cell in one 64-bit word
+struct PackedState
+{
+    static const int MAX_CELLS = 16;
+
+    uint64_t tiles = 0;
+    uint8_t blank = 0;
+
+    int tile(int cell) const { return static_cast<int>((tiles >> (4 * cell)) & 0xF); }
+
+    void set_tile(int cell, int value)
+    {
+        tiles = (tiles & ~(0xFULL << (4 * cell))) | (static_cast<uint64_t>(value) << (4 * cell));
+        if (value == 0)
+            blank = static_cast<uint8_t>(cell);
+    }
+
+    // Sliding the tile at cell into the blank
+    void move_blank(int cell)
+    {
+        uint64_t value = (tiles >> (4 * cell)) & 0xF;
+        tiles ^= (value << (4 * cell)) | (value << (4 * blank));
+        blank = static_cast<uint8_t>(cell);
+    }
+
+    uint64_t hash() const
+    {
+        uint64_t hash = tiles + 0x9E3779B97F4A7C15ULL;
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+        return hash ^ (hash >> 31);
+    }
+
+    bool operator==(const PackedState &other) const { return tiles == other.tiles; }
+};
+
+// Zobrist keys of (tile, cell) pairs, the same for every byte state size
+inline uint64_t zobrist_key(int tile, int cell)
+{
+    static const vector<uint64_t> keys = []
+    {
+        vector<uint64_t> k(256 * 256);
+        uint64_t state = 0x2545F4914F6CDD1DULL;
+        for (auto &key : k)
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            key = state * 0x2545F4914F6CDD1DULL;
+        }
+        return k;
+    }();
+    return keys[tile * 256 + cell];
+}
+
+// Larger boards: one byte per cell, the Zobrist hash is kept up to date on every move
+// (relative to the all-blank board, so a default state hashes to 0)
+template <int CELLS>
+struct ByteState
+{
+    static const int MAX_CELLS = CELLS;
+    static_assert(CELLS <= 256, "tiles must fit one byte");
+
+    array<uint8_t, CELLS> tiles = {};
+    uint8_t blank = 0;
+    uint64_t zobrist = 0;
+
+    int tile(int cell) const { return tiles[cell]; }
+
+    void set_tile(int cell, int value)
+    {
+        zobrist ^= zobrist_key(tiles[cell], cell) ^ zobrist_key(value, cell);
+        tiles[cell] = static_cast<uint8_t>(value);
+        if (value == 0)
+            blank = static_cast<uint8_t>(cell);
+    }
+
+    void move_blank(int cell)
+    {
+        int value = tiles[cell];
+        zobrist ^= zobrist_key(value, cell) ^ zobrist_key(value, blank) ^ zobrist_key(0, blank) ^ zobrist_key(0, cell);
+        tiles[blank] = static_cast<uint8_t>(value);
+        tiles[cell] = 0;
+        blank = static_cast<uint8_t>(cell);
+    }
+
+    uint64_t hash() const { return zobrist; }
+
+    bool operator==(const ByteState &other) const { return zobrist == other.zobrist && tiles == other.tiles; }
+};
+
+template <class State>
+struct StateHash
+{
+    size_t operator()(const State &state) const { return state.hash(); }
+};
+
+template <class State>
+State state_from_grid(const vector<vector<int>> &grid)
+{
+    int n = grid.size();
+    State state;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            state.set_tile(i * n + j, grid[i][j]);
+    return state;
+}
+
+template <class State>
+vector<vector<int>> state_to_grid(const State &state, int n)
+{
+    vector<vector<int>> grid(n, vector<int>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            grid[i][j] = state.tile(i * n + j);
+    return grid;
+}
+
+// Letter of the blank's move from cell from to the neighbouring cell to: U, D, L or R
+inline char move_letter(int from, int to, int n)
+{
+    if (to == from - n)
+        return 'U';
+    if (to == from + n)
+        return 'D';
+    return to == from - 1 ? 'L' : 'R';
+}
+
+// Moves of the blank along a path of states from the start, one letter per move
+template <class State>
+string move_string(const vector<State> &path, int n)
+{
+    string moves;
+    moves.reserve(path.empty() ? 0 : path.size() - 1);
+    for (size_t i = 1; i < path.size(); ++i)
+        moves += move_letter(path[i - 1].blank, path[i].blank, n);
+    return moves;
+}
+
+// Goal of an n x n board: tiles 1 .. n*n-1 in row major order, blank in the last cell
+template <class State>
+State goal_state_of(int n)
+{
+    State state;
+    for (int cell = 0; cell < n * n - 1; ++cell)
+        state.set_tile(cell, cell + 1);
+    state.blank = static_cast<uint8_t>(n * n - 1);
+    return state;
+}
+
+// Inversions of the tiles in row major order (the blank skipped), counted with a Fenwick tree over
+// tile values in O(N log N); -1 unless the tiles are 0 .. cells-1, each once
+template <class TileAt>
+long long count_inversions(int cells, TileAt tile_at)
+{
+    vector<int> tree(cells, 0); // tiles seen so far, by value
+    vector<bool> seen(cells, false);
+    long long inversions = 0;
+    int tiles_seen = 0;
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        int tile = tile_at(cell);
+        if (tile < 0 || tile >= cells || seen[tile])
+            return -1;
+        seen[tile] = true;
+        if (tile == 0)
+            continue;
+
+        int not_larger = 0;
+        for (int i = tile; i > 0; i -= i & -i)
+            not_larger += tree[i];
+        inversions += tiles_seen - not_larger;
+        for (int i = tile; i < cells; i += i & -i)
+            tree[i]++;
+        tiles_seen++;
+    }
+    return inversions;
+}
+
+// Whether the goal can be reached from an n x n board with its blank in row blank_row:
+// for odd n the inversions must be even, for even n the inversions plus the blank's row from the bottom odd
+template <class TileAt>
+bool is_solvable(int n, int blank_row, TileAt tile_at)
+{
+    long long inversions = count_inversions(n * n, tile_at);
+    if (inversions < 0)
+        return false;
+    if (n % 2 != 0)
+        return inversions % 2 == 0;
+    return (n - blank_row + inversions) % 2 != 0;
+}
+
+template <class State>
+bool is_solvable(const State &state, int n)
+{
+    return is_solvable(n, state.blank / n, [&](int cell)
+                       { return state.tile(cell); });
+}
+
+// Calling function with a default state of the smallest type that holds an n x n board,
+// false if the board is too large for byte tiles
+template <class Function>
+bool with_puzzle_state(int n, Function function)
+{
+    if (n <= 4)
+        function(PackedState());
+    else if (n <= 6)
+        function(ByteState<36>());
+    else if (n <= 16)
+        function(ByteState<256>());
+    else
+        return false;
+    return true;
+}
\ No newline at end of file